@@ -0,0 +1,329 @@
+#include "DealExtractor.h"
+#include <algorithm>
+
+namespace {
+
+constexpr double kVolumeEpsilon = 1e-8;
+
+bool equalsIgnoreCase(std::string_view text, std::string_view lower)
+{
+    if (text.size() != lower.size()) return false;
+    for (size_t i = 0; i < text.size(); ++i) {
+        char c = text[i];
+        if (c >= 'A' && c <= 'Z') c = static_cast<char>(c - 'A' + 'a');
+        if (c != lower[i]) return false;
+    }
+    return true;
+}
+
+// days since 1970-01-01 of a proleptic Gregorian date
+qint64 daysFromCivil(qint64 year, unsigned month, unsigned day)
+{
+    year -= month <= 2;
+    const qint64 era = (year >= 0 ? year : year - 399) / 400;
+    const unsigned yearOfEra = static_cast<unsigned>(year - era * 400);
+    const unsigned dayOfYear = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    const unsigned dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return era * 146097 + static_cast<qint64>(dayOfEra) - 719468;
+}
+
+}
+
+void TradeTable::clear()
+{
+    openTime.clear();
+    closeTime.clear();
+    volume.clear();
+    profit.clear();
+    commission.clear();
+    swap.clear();
+    outcome.clear();
+}
+
+DealExtractor::DealExtractor()
+    : m_headerFound(false)
+    , m_initialBalance(0.0)
+{
+    m_columns.fill(-1);
+}
+
+TradeTable DealExtractor::takeTrades()
+{
+    TradeTable trades = std::move(m_trades);
+    m_trades.clear();
+    return trades;
+}
+
+void DealExtractor::addRow(const QVector<std::string_view> &cells)
+{
+    if (cells.isEmpty()) {
+        return;
+    }
+
+    if (!m_headerFound) {
+        m_headerFound = resolveColumns(cells);
+        return;
+    }
+
+    std::string_view type = cell(cells, Type);
+    bool isBuy = equalsIgnoreCase(type, "buy");
+    bool isSell = equalsIgnoreCase(type, "sell");
+
+    if (!isBuy && !isSell) {
+        // the first balance operation is the deposit the test started with
+        if (equalsIgnoreCase(type, "balance") && m_initialBalance == 0.0) {
+            bool ok = false;
+            double balance = parseNumber(cell(cells, Balance), &ok);
+            m_initialBalance = (ok && balance > 0) ? balance : number(cells, Profit);
+        }
+        return;
+    }
+
+    std::string_view direction = cell(cells, Direction);
+    const bool reversal = equalsIgnoreCase(direction, "in/out");
+    const bool entry = equalsIgnoreCase(direction, "in");
+    if (!entry && !reversal && !equalsIgnoreCase(direction, "out") && !equalsIgnoreCase(direction, "out/by")) {
+        return;
+    }
+
+    Deal deal;
+    deal.time = parseTime(cell(cells, Time));
+    deal.volume = number(cells, Volume);
+    deal.profit = number(cells, Profit);
+    deal.commission = number(cells, Commission);
+    deal.swap = number(cells, Swap);
+    deal.isBuy = isBuy;
+
+    if (m_columns[Position] >= 0) {
+        std::string_view position = cell(cells, Position);
+        addPositionDeal(QByteArray(position.data(), static_cast<int>(position.size())), deal, entry, reversal);
+    } else {
+        std::string_view symbol = cell(cells, Symbol);
+        addSymbolDeal(QByteArray(symbol.data(), static_cast<int>(symbol.size())), deal, entry, reversal);
+    }
+}
+
+void DealExtractor::addPositionDeal(const QByteArray &key, const Deal &deal, bool entry, bool reversal)
+{
+    if (entry) {
+        auto it = m_open.find(key);
+        if (it == m_open.end()) {
+            OpenPosition position;
+            position.openTime = deal.time;
+            it = m_open.insert(key, position);
+        }
+        it->openVolume += deal.volume;
+        it->entryVolume += deal.volume;
+        it->profit += deal.profit;
+        it->commission += deal.commission;
+        it->swap += deal.swap;
+        return;
+    }
+
+    auto it = m_open.find(key);
+    if (it == m_open.end()) {
+        closeOrphan(deal, deal.volume);
+        return;
+    }
+
+    it->profit += deal.profit;
+    it->commission += deal.commission;
+    it->swap += deal.swap;
+
+    // a reversal closes the whole position and opens the rest the other way
+    const double closedVolume = reversal ? it->openVolume : deal.volume;
+    const double reversedVolume = reversal ? deal.volume - it->openVolume : 0;
+    it->openVolume -= closedVolume;
+
+    if (m_columns[Volume] < 0 || it->openVolume <= kVolumeEpsilon) {
+        closePosition(*it, deal.time);
+        m_open.erase(it);
+
+        if (reversedVolume > kVolumeEpsilon) {
+            OpenPosition position;
+            position.openTime = deal.time;
+            position.openVolume = reversedVolume;
+            position.entryVolume = reversedVolume;
+            m_open.insert(key, position);
+        }
+    }
+}
+
+void DealExtractor::addSymbolDeal(const QByteArray &symbol, const Deal &deal, bool entry, bool reversal)
+{
+    // without position ids every entry is its own lot, queued per symbol and side,
+    // and exits close the oldest lots of the opposite side first
+    const QByteArray entrySide = symbol + (deal.isBuy ? ":buy" : ":sell");
+    const QByteArray exitSide = symbol + (deal.isBuy ? ":sell" : ":buy");
+
+    if (entry) {
+        OpenPosition lot;
+        lot.openTime = deal.time;
+        lot.openVolume = deal.volume;
+        lot.entryVolume = deal.volume;
+        lot.profit = deal.profit;
+        lot.commission = deal.commission;
+        lot.swap = deal.swap;
+        m_lots[entrySide].append(lot);
+        return;
+    }
+
+    QVector<OpenPosition> &lots = m_lots[exitSide];
+
+    if (m_columns[Volume] < 0) {
+        // no volumes to split by, the deal closes the oldest lot whole
+        if (lots.isEmpty()) {
+            closeOrphan(deal, 0);
+            return;
+        }
+        OpenPosition lot = lots.takeFirst();
+        lot.profit += deal.profit;
+        lot.commission += deal.commission;
+        lot.swap += deal.swap;
+        closePosition(lot, deal.time);
+        return;
+    }
+
+    // a reversal closes everything open against it and opens the rest
+    double openVolume = 0;
+    for (const auto &lot : lots) {
+        openVolume += lot.openVolume;
+    }
+    const double closingVolume = reversal ? std::min(openVolume, deal.volume) : deal.volume;
+    const double reversedVolume = reversal ? deal.volume - closingVolume : 0;
+
+    // profit and swap belong to the closing part of the deal, commission to its whole
+    // volume; each lot takes its share by the volume it closes
+    double remaining = closingVolume;
+    while (remaining > kVolumeEpsilon && !lots.isEmpty()) {
+        OpenPosition &lot = lots.first();
+        const double closed = std::min(lot.openVolume, remaining);
+        const double closingShare = closingVolume > 0 ? closed / closingVolume : 1.0;
+        const double volumeShare = deal.volume > 0 ? closed / deal.volume : 1.0;
+
+        lot.profit += deal.profit * closingShare;
+        lot.commission += deal.commission * volumeShare;
+        lot.swap += deal.swap * closingShare;
+        lot.openVolume -= closed;
+        remaining -= closed;
+
+        if (lot.openVolume <= kVolumeEpsilon) {
+            closePosition(lot, deal.time);
+            lots.removeFirst();
+        }
+    }
+
+    if (remaining > kVolumeEpsilon) {
+        closeOrphan(deal, remaining);
+    }
+
+    if (reversedVolume > kVolumeEpsilon) {
+        OpenPosition lot;
+        lot.openTime = deal.time;
+        lot.openVolume = reversedVolume;
+        lot.entryVolume = reversedVolume;
+        lot.commission = deal.commission * reversedVolume / deal.volume;
+        m_lots[entrySide].append(lot);
+    }
+}
+
+void DealExtractor::closeOrphan(const Deal &deal, double volume)
+{
+    // closing volume without a matching entry, that part of the deal alone is the trade
+    const double share = (deal.volume > 0 && volume > 0) ? volume / deal.volume : 1.0;
+    OpenPosition orphan;
+    orphan.openTime = deal.time;
+    orphan.entryVolume = volume;
+    orphan.profit = deal.profit * share;
+    orphan.commission = deal.commission * share;
+    orphan.swap = deal.swap * share;
+    closePosition(orphan, deal.time);
+}
+
+bool DealExtractor::resolveColumns(const QVector<std::string_view> &cells)
+{
+    static const std::array<std::string_view, ColumnCount> names = {
+        "time", "symbol", "type", "direction", "volume",
+        "commission", "swap", "profit", "balance", "position"
+    };
+
+    m_columns.fill(-1);
+    for (int i = 0; i < cells.size(); ++i) {
+        for (int c = 0; c < ColumnCount; ++c) {
+            if (m_columns[c] < 0 && equalsIgnoreCase(cells[i], names[c])) {
+                m_columns[c] = i;
+                break;
+            }
+        }
+    }
+
+    return m_columns[Type] >= 0 && m_columns[Direction] >= 0 && m_columns[Profit] >= 0;
+}
+
+std::string_view DealExtractor::cell(const QVector<std::string_view> &cells, Column column) const
+{
+    int index = m_columns[column];
+    return (index >= 0 && index < cells.size()) ? cells[index] : std::string_view();
+}
+
+double DealExtractor::number(const QVector<std::string_view> &cells, Column column) const
+{
+    return parseNumber(cell(cells, column));
+}
+
+void DealExtractor::closePosition(const OpenPosition &position, qint64 closeTime)
+{
+    m_trades.openTime.append(position.openTime);
+    m_trades.closeTime.append(closeTime);
+    m_trades.volume.append(position.entryVolume);
+    m_trades.profit.append(position.profit);
+    m_trades.commission.append(position.commission);
+    m_trades.swap.append(position.swap);
+    m_trades.outcome.append(position.profit + position.commission + position.swap);
+}
+
+double DealExtractor::parseNumber(std::string_view text, bool *ok)
+{
+    // drop thousands separators ("10 000.00") and stop at "0.1 / 0.1" volume pairs
+    char buffer[64];
+    int length = 0;
+    for (char c : text) {
+        if (c == '/') break;
+        if (c == ' ' || c == '\'' || c == '\xc2' || c == '\xa0') continue;
+        if (length == static_cast<int>(sizeof(buffer))) break;
+        buffer[length++] = c;
+    }
+
+    bool parsed = false;
+    double value = length > 0 ? QByteArray::fromRawData(buffer, length).toDouble(&parsed) : 0.0;
+    if (ok) *ok = parsed;
+    return parsed ? value : 0.0;
+}
+
+qint64 DealExtractor::parseTime(std::string_view text)
+{
+    // "2024.01.31 23:59:59", any non-digit separates the fields
+    qint64 fields[6] = {0, 0, 0, 0, 0, 0};
+    int count = 0;
+    bool inNumber = false;
+    for (char c : text) {
+        if (c >= '0' && c <= '9') {
+            if (!inNumber) {
+                if (count == 6) break;
+                inNumber = true;
+                ++count;
+            }
+            fields[count - 1] = fields[count - 1] * 10 + (c - '0');
+        } else {
+            inNumber = false;
+        }
+    }
+
+    if (count < 3 || fields[1] < 1 || fields[1] > 12 || fields[2] < 1 || fields[2] > 31) {
+        return 0;
+    }
+
+    qint64 days = daysFromCivil(fields[0], static_cast<unsigned>(fields[1]), static_cast<unsigned>(fields[2]));
+    qint64 seconds = days * 86400 + fields[3] * 3600 + fields[4] * 60 + fields[5];
+    return seconds * 1000;
+}
@@ -0,0 +1,95 @@
+#ifndef DEALEXTRACTOR_H
+#define DEALEXTRACTOR_H
+
+#include <QHash>
+#include <QByteArray>
+#include <QVector>
+#include <array>
+#include <string_view>
+
+
+// closed positions as parallel columns, one entry per position
+struct TradeTable {
+    QVector<qint64> openTime;     // ms since epoch, report (server) time
+    QVector<qint64> closeTime;
+    QVector<double> volume;       // lots opened
+    QVector<double> profit;       // gross profit of all closing deals
+    QVector<double> commission;   // entry and exit commission
+    QVector<double> swap;
+    QVector<double> outcome;      // profit + commission + swap
+
+    int size() const { return outcome.size(); }
+    void clear();
+};
+
+
+// builds a TradeTable from the rows of an MT5 report, whatever its layout.
+// column indices are resolved once from the first header row naming Type,
+// Direction and Profit (only the Deals table has all three). deals are matched
+// by the Position column when the report has one, so partial closes add up into
+// a single trade. tester reports have none; there every entry deal is its own
+// trade and exits close the oldest entries of the symbol first
+class DealExtractor
+{
+public:
+    DealExtractor();
+
+    void addRow(const QVector<std::string_view> &cells);
+
+    TradeTable takeTrades();
+    double initialBalance() const { return m_initialBalance; }
+    bool foundDeals() const { return m_headerFound; }
+
+    static double parseNumber(std::string_view text, bool *ok = nullptr);
+    static qint64 parseTime(std::string_view text);
+
+private:
+    enum Column {
+        Time,
+        Symbol,
+        Type,
+        Direction,
+        Volume,
+        Commission,
+        Swap,
+        Profit,
+        Balance,
+        Position,
+        ColumnCount
+    };
+
+    struct OpenPosition {
+        qint64 openTime = 0;
+        double openVolume = 0;
+        double entryVolume = 0;
+        double profit = 0;
+        double commission = 0;
+        double swap = 0;
+    };
+
+    struct Deal {
+        qint64 time = 0;
+        double volume = 0;
+        double profit = 0;
+        double commission = 0;
+        double swap = 0;
+        bool isBuy = false;
+    };
+
+    void addPositionDeal(const QByteArray &key, const Deal &deal, bool entry, bool reversal);
+    void addSymbolDeal(const QByteArray &symbol, const Deal &deal, bool entry, bool reversal);
+    void closeOrphan(const Deal &deal, double volume);
+    bool resolveColumns(const QVector<std::string_view> &cells);
+    std::string_view cell(const QVector<std::string_view> &cells, Column column) const;
+    double number(const QVector<std::string_view> &cells, Column column) const;
+    void closePosition(const OpenPosition &position, qint64 closeTime);
+
+    bool m_headerFound;
+    std::array<int, ColumnCount> m_columns;
+    QHash<QByteArray, OpenPosition> m_open;              // by position id
+    QHash<QByteArray, QVector<OpenPosition>> m_lots;     // by symbol and side, oldest first
+    TradeTable m_trades;
+    double m_initialBalance;
+};
+
+#endif
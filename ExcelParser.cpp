@@ -1,6 +1,36 @@
 #include "ExcelParser.h"
 #include <QDebug>
+#include <QFile>
+#include <QFileInfo>
 #include <QUrl>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+// MT5 writes deal times as text, but a re-saved workbook may hold real dates
+std::string cellText(const xlnt::cell &cell)
+{
+    if (cell.has_value() && cell.is_date()) {
+        xlnt::datetime dt = cell.value<xlnt::datetime>();
+        char buffer[32];
+        std::snprintf(buffer, sizeof(buffer), "%04d.%02d.%02d %02d:%02d:%02d",
+                      dt.year, dt.month, dt.day, dt.hour, dt.minute, dt.second);
+        return buffer;
+    }
+    // numbers are written raw: to_string() applies the display format, which groups
+    // thousands and rounds to the shown decimals
+    if (cell.has_value() && cell.data_type() == xlnt::cell_type::number) {
+        char buffer[32];
+        std::snprintf(buffer, sizeof(buffer), "%.17g", cell.value<double>());
+        return buffer;
+    }
+    return cell.to_string();
+}
+
+}
 
 ExcelParser::ExcelParser(QObject *parent)
     : QObject(parent), m_initialBalance(0.0)
@@ -12,97 +42,141 @@ void ExcelParser::parseExcelFile(const QString &filePath)
     m_trades.clear();
     m_initialBalance = 0.0;
 
+    try {
+        ParsedReport report = parseReport(filePath, [this](int current, int total) {
+            emit parsingProgress(current, total);
+        });
+
+        m_initialBalance = report.initialBalance;
+        m_trades = std::move(report.trades);
+
+        emit parsingComplete(m_initialBalance, m_trades.size());
+
+    } catch (const std::exception &e) {
+        QString errorMsg = QString("Failed to parse report: %1").arg(e.what());
+        qDebug() << errorMsg;
+        emit parsingFailed(errorMsg);
+    }
+}
+
+ExcelParser::ParsedReport ExcelParser::parseReport(const QString &filePath, const ProgressCallback &progress)
+{
+    const QString localPath = localFilePath(filePath);
+
+    DealExtractor extractor;
+
+    const QString suffix = QFileInfo(localPath).suffix().toLower();
+    if (suffix == "csv" || suffix == "txt") {
+        parseText(localPath, ReportTokenizer::Format::Csv, extractor, progress);
+    } else if (suffix == "htm" || suffix == "html") {
+        parseText(localPath, ReportTokenizer::Format::Html, extractor, progress);
+    } else {
+        parseXlsx(localPath, extractor, progress);
+    }
+
+    if (!extractor.foundDeals()) {
+        throw std::runtime_error("no deals table found in the report");
+    }
+
+    ParsedReport report;
+    report.initialBalance = extractor.initialBalance();
+    report.trades = extractor.takeTrades();
+    return report;
+}
+
+QString ExcelParser::localFilePath(const QString &filePath)
+{
     QString localPath = filePath;
     if (localPath.startsWith("file://")) {
         QUrl url(filePath);
         localPath = url.toLocalFile();
     }
+    return localPath;
+}
 
-    try {
-        xlnt::workbook wb;
-        wb.load(localPath.toStdString());
+void ExcelParser::parseXlsx(const QString &filePath, DealExtractor &extractor, const ProgressCallback &progress)
+{
+    xlnt::workbook wb;
+    wb.load(filePath.toStdString());
+
+    auto sheet = wb.active_sheet();
 
-        auto sheet = wb.active_sheet();
+    const int totalRows = static_cast<int>(sheet.highest_row());
+    int currentRow = 0;
 
-        bool dealsSectionFound = false;
-        bool columnNamesRowFound = false;
+    std::vector<std::string> texts;
+    QVector<std::string_view> cells;
 
-        auto rows = sheet.rows();
-        int totalRows = 0;
-        int currentRow = 0;
+    for (auto row : sheet.rows(false))
+    {
+        currentRow++;
 
-        for (auto it = rows.begin(); it != rows.end(); ++it) {
-            totalRows++;
+        // give progress every 10 rows
+        if (progress && currentRow % 10 == 0) {
+            progress(currentRow, totalRows);
         }
 
-        for (auto rowIter = rows.begin(); rowIter != rows.end(); ++rowIter)
-        {
-            currentRow++;
-
-            // give progress every 10 rows
-            if (currentRow % 10 == 0) {
-                emit parsingProgress(currentRow, totalRows);
-            }
-
-            auto row = *rowIter;
-            std::string cellValue = row[0].to_string();
-
-            if (cellValue == "Deals")
-            {
-                dealsSectionFound = true;
-                continue;
-            }
-
-            if (dealsSectionFound)
-            {
-                if (!columnNamesRowFound)
-                {
-                    columnNamesRowFound = true;
-                    continue;
-                }
-
-                if (m_initialBalance == 0.0)
-                {
-                    m_initialBalance = row[11].value<double>();
-                    continue;
-                }
-
-                if (row[4].to_string() == "in")
-                {
-                    std::string type = row[3].to_string();
-
-                    if (++rowIter != rows.end())
-                    {
-                        auto nextRow = *rowIter;
-                        double outcome = nextRow[10].value<double>();
-
-                        Trade trade;
-                        trade.type = QString::fromStdString(type);
-                        trade.outcome = outcome;
-                        m_trades.append(trade);
-
-                    }
-                }
-            }
+        texts.clear();
+        for (std::size_t i = 0; i < row.length(); ++i) {
+            texts.push_back(cellText(row[i]));
         }
 
-        emit parsingComplete(m_initialBalance, m_trades.size());
+        cells.clear();
+        for (const auto &text : texts) {
+            cells.append(text);
+        }
 
-    } catch (const std::exception &e) {
-        QString errorMsg = QString("Failed to parse Excel file: %1").arg(e.what());
-        qDebug() << errorMsg;
-        emit parsingFailed(errorMsg);
+        extractor.addRow(cells);
     }
 }
 
-QVector<double> ExcelParser::getTradeOutcomes() const
+void ExcelParser::parseText(const QString &filePath, ReportTokenizer::Format format, DealExtractor &extractor,
+                            const ProgressCallback &progress)
 {
-    QVector<double> outcomes;
-    outcomes.reserve(m_trades.size());
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        throw std::runtime_error(file.errorString().toStdString());
+    }
+
+    // map the report and tokenize it in place; fall back to reading it when mapping is unavailable
+    const qint64 size = file.size();
+    QByteArray contents;
+    std::string_view data;
+    if (uchar *mapped = size > 0 ? file.map(0, size) : nullptr) {
+        data = std::string_view(reinterpret_cast<const char *>(mapped), static_cast<size_t>(size));
+    } else {
+        contents = file.readAll();
+        data = std::string_view(contents.constData(), static_cast<size_t>(contents.size()));
+    }
+
+    // the MT5 HTML export is UTF-16LE, which is transcoded once; UTF-8 and ASCII are read as is
+    QByteArray utf8;
+    if (data.size() >= 2 && static_cast<uchar>(data[0]) == 0xFF && static_cast<uchar>(data[1]) == 0xFE) {
+        utf8 = QString::fromUtf16(reinterpret_cast<const char16_t *>(data.data() + 2),
+                                  static_cast<qsizetype>((data.size() - 2) / 2)).toUtf8();
+        data = std::string_view(utf8.constData(), static_cast<size_t>(utf8.size()));
+    } else if (data.size() >= 3 && static_cast<uchar>(data[0]) == 0xEF
+               && static_cast<uchar>(data[1]) == 0xBB && static_cast<uchar>(data[2]) == 0xBF) {
+        data.remove_prefix(3);
+    }
+
+    ReportTokenizer tokenizer(data, format);
+    QVector<std::string_view> cells;
+    int currentRow = 0;
 
-    for (const auto &trade : m_trades) {
-        outcomes.append(trade.outcome);
+    while (tokenizer.nextRow(cells)) {
+        currentRow++;
+
+        // progress in percent of the bytes consumed
+        if (progress && currentRow % 256 == 0 && tokenizer.size() > 0) {
+            progress(static_cast<int>(tokenizer.position() * 100 / tokenizer.size()), 100);
+        }
+
+        extractor.addRow(cells);
     }
+}
 
-    return outcomes;
+QVector<double> ExcelParser::getTradeOutcomes() const
+{
+    return m_trades.outcome;
 }
@@ -6,6 +6,9 @@
 #include <QVariant>
 #include <xlnt/xlnt.hpp>
 #include <QVector>
+#include <functional>
+#include "DealExtractor.h"
+#include "ReportTokenizer.h"
 
 
 class ExcelParser : public QObject
@@ -17,7 +20,19 @@ public:
     Q_INVOKABLE QVector<double> getTradeOutcomes() const;
     Q_INVOKABLE double getInitialBalance() const { return m_initialBalance; }
 
+    struct ParsedReport {
+        TradeTable trades;
+        double initialBalance = 0.0;
+    };
+
+    using ProgressCallback = std::function<void(int current, int total)>;
+
+    // parses one report without touching parser state, safe to run on worker threads; throws on failure
+    static ParsedReport parseReport(const QString &filePath, const ProgressCallback &progress = ProgressCallback());
+    static QString localFilePath(const QString &filePath);
+
 public slots:
+    // accepts MT5 .xlsx reports as well as .csv and .htm/.html exports
     void parseExcelFile(const QString &filePath);
 
 signals:
@@ -27,12 +42,11 @@ signals:
 
 
 private:
-    struct Trade {
-        QString type;
-        double outcome;
-    };
+    static void parseXlsx(const QString &filePath, DealExtractor &extractor, const ProgressCallback &progress);
+    static void parseText(const QString &filePath, ReportTokenizer::Format format, DealExtractor &extractor,
+                          const ProgressCallback &progress);
 
-    QList<Trade> m_trades;
+    TradeTable m_trades;
     double m_initialBalance;
 
 };
@@ -23,10 +23,17 @@ ApplicationWindow  {
     property bool fileLoaded: false
     property bool simulationRunning: false
     property string loadedFilePath: ""
+    property var loadedFilePaths: []        // more than one path runs the basket as a portfolio
     property bool isTransitioning: false
+    property bool dashboardRequested: false // results panels are only built after the first run
 
     property int simNumRuns: 1000
     property bool simRandomize: true
+    property bool simDayBlocks: true        // baskets resample whole days instead of single trades
+    property int simSampling: 0             // MonteCarloSimulator::SamplingMode
+    property bool simStress: false          // replay every run under the stress preset
+    property bool simSharded: false         // the running job went to the shard launcher
+    readonly property int shardedRunThreshold: 2000
 
         function formatNumber(num, decimals) {
             return num.toFixed(decimals)
@@ -278,7 +285,7 @@ ApplicationWindow  {
 
                     onClicked: {
                             if (!window.fileLoaded) {
-                                statusBarManager.setError("Please load a MT5 backtest report Excel file first")
+                                statusBarManager.setError("Please load a MT5 backtest report file first")
                                 return
                             }
 
@@ -291,13 +298,15 @@ ApplicationWindow  {
                          clearGraphData()
                          window.simNumRuns = Math.round(numOfRunsSlider.value)
                          window.simRandomize = randomizeOrderToggleSwitch.checked
+                         window.simDayBlocks = dayBlocksToggleSwitch.checked
+                         window.simSampling = samplingModeSelector.mode
+                         window.simStress = stressToggleSwitch.checked
 
                         // update ui state
                         window.simulationRunning = true
                         runButton.isSimulating = true
 
-                       statusBarManager.setParsingFile(window.loadedFilePath)
-                       excelParser.parseExcelFile(window.loadedFilePath)
+                       startParsing()
                     }
                 }
 
@@ -353,7 +362,11 @@ ApplicationWindow  {
                     enabled: runButton.isSimulating
 
                     onClicked: {
-                        monteCarloSimulator.stopSimulation()
+                        if (window.simSharded) {
+                            shardLauncher.stopSimulation()
+                        } else {
+                            monteCarloSimulator.stopSimulation()
+                        }
                         runButton.isSimulating = false
                     }
                 }
@@ -474,6 +487,37 @@ ApplicationWindow  {
 
                      }
 
+                    // weights of a basket's reports, in the order they were picked
+                    Rectangle {
+                        width: parent.width
+                        height: 30
+                        visible: window.loadedFilePaths.length > 1
+                        color: "#1a1d29"
+                        border.color: "#334155"
+                        border.width: 1
+                        radius: 4
+
+                        TextInput {
+                            id: basketWeightsInput
+                            anchors.fill: parent
+                            anchors.leftMargin: 10
+                            anchors.rightMargin: 10
+                            verticalAlignment: TextInput.AlignVCenter
+                            color: "#94a3b8"
+                            font.pixelSize: 12
+                            clip: true
+                            validator: RegularExpressionValidator { regularExpression: /^[0-9.,\s]*$/ }
+
+                            Text {
+                                anchors.verticalCenter: parent.verticalCenter
+                                visible: !basketWeightsInput.text && !basketWeightsInput.activeFocus
+                                text: "Weights, e.g. 1, 0.5 (1 each by default)"
+                                color: "#64748b"
+                                font.pixelSize: 12
+                            }
+                        }
+                    }
+
 
 
                 }
@@ -822,6 +866,238 @@ ApplicationWindow  {
                         }
                     }
 
+                    // day block section, only for baskets
+                    Rectangle {
+                        width: parent.width
+                        height: 30
+                        visible: window.loadedFilePaths.length > 1
+                        color: "transparent"
+
+                        Row {
+                            width: parent.width
+                            anchors.verticalCenter: parent.verticalCenter
+                            leftPadding: 10
+                            rightPadding: 10
+
+                            Text {
+                                text: "Resample Whole Days"
+                                color: "#B3FFFFFF"
+                                font.pixelSize: 13
+                                anchors.verticalCenter: parent.verticalCenter
+                            }
+
+                            Item {
+                                width: parent.width - 200
+                                height: 1
+                            }
+
+                            // day block toggle switch
+                            Rectangle {
+                                width: 40
+                                height: 20
+                                radius: 13
+                                color: dayBlocksToggleSwitch.checked ? "#0ea5e9" : "#2d3139"
+                                border.color: dayBlocksToggleSwitch.checked ? "#0284c7" : "#1e293b"
+                                border.width: 1
+                                anchors.verticalCenter: parent.verticalCenter
+
+                                Behavior on color {
+                                    ColorAnimation { duration: 200 }
+                                }
+
+                                Rectangle {
+                                    width: 18
+                                    height: 18
+                                    radius: 10
+                                    color: "#e5e5e5"
+                                    x: dayBlocksToggleSwitch.checked ? parent.width - width - 3 : 3
+                                    anchors.verticalCenter: parent.verticalCenter
+
+                                    Behavior on x {
+                                        NumberAnimation { duration: 200; easing.type: Easing.InOutQuad }
+                                    }
+                                }
+
+                                MouseArea {
+                                    id: dayBlocksToggleSwitch
+                                    anchors.fill: parent
+                                    cursorShape: Qt.PointingHandCursor
+                                    property bool checked: true
+
+                                    onClicked: {
+                                        checked = !checked
+                                    }
+                                }
+                            }
+                        }
+                    }
+
+                    // stress scenario fields, in setStressScenario order
+                    Rectangle {
+                        width: parent.width - 20
+                        height: 30
+                        anchors.horizontalCenter: parent.horizontalCenter
+                        visible: stressToggleSwitch.checked
+                        color: "#1a1d29"
+                        border.color: "#334155"
+                        border.width: 1
+                        radius: 4
+
+                        TextInput {
+                            id: stressScenarioInput
+                            anchors.fill: parent
+                            anchors.leftMargin: 10
+                            anchors.rightMargin: 10
+                            verticalAlignment: TextInput.AlignVCenter
+                            color: "#94a3b8"
+                            font.pixelSize: 12
+                            clip: true
+                            text: "10, 10, 5, 0, 2, 5"
+                            validator: RegularExpressionValidator { regularExpression: /^[0-9.,\s]*$/ }
+                        }
+                    }
+
+                    Text {
+                        width: parent.width - 20
+                        anchors.horizontalCenter: parent.horizontalCenter
+                        visible: stressToggleSwitch.checked
+                        text: "win cut %, loss inflation %, skip %, cost per trade, streaks, streak length"
+                        color: "#64748b"
+                        font.pixelSize: 10
+                        wrapMode: Text.WordWrap
+                    }
+
+                    // divider line
+                    Rectangle {
+                        width: parent.width - 20
+                        height: 1
+                        color: "#2d3139"
+                        anchors.horizontalCenter: parent.horizontalCenter
+                    }
+
+
+                    // sampling mode section
+                    Rectangle {
+                        width: parent.width
+                        height: 30
+                        color: "transparent"
+
+                        Row {
+                            width: parent.width
+                            anchors.verticalCenter: parent.verticalCenter
+                            leftPadding: 10
+                            rightPadding: 10
+
+                            Text {
+                                text: "Sampling"
+                                color: "#B3FFFFFF"
+                                font.pixelSize: 13
+                                anchors.verticalCenter: parent.verticalCenter
+                            }
+
+                            Item {
+                                width: parent.width - 170
+                                height: 1
+                            }
+
+                            // toggles independent <-> stratified
+                            Text {
+                                id: samplingModeText
+                                width: 90
+                                text: ["Independent", "Stratified"][samplingModeSelector.mode]
+                                color: samplingModeSelector.mode > 0 ? "#0ea5e9" : "#777"
+                                font.pixelSize: 13
+                                horizontalAlignment: Text.AlignRight
+                                anchors.verticalCenter: parent.verticalCenter
+
+                                MouseArea {
+                                    id: samplingModeSelector
+                                    anchors.fill: parent
+                                    cursorShape: Qt.PointingHandCursor
+                                    property int mode: 0
+
+                                    onClicked: {
+                                        mode = (mode + 1) % 2
+                                    }
+                                }
+                            }
+                        }
+                    }
+
+                    // divider line
+                    Rectangle {
+                        width: parent.width - 20
+                        height: 1
+                        color: "#2d3139"
+                        anchors.horizontalCenter: parent.horizontalCenter
+                    }
+
+
+                    // stress test section
+                    Rectangle {
+                        width: parent.width
+                        height: 30
+                        color: "transparent"
+
+                        Row {
+                            width: parent.width
+                            anchors.verticalCenter: parent.verticalCenter
+                            leftPadding: 10
+                            rightPadding: 10
+
+                            Text {
+                                text: "Stress Test"
+                                color: "#B3FFFFFF"
+                                font.pixelSize: 13
+                                anchors.verticalCenter: parent.verticalCenter
+                            }
+
+                            Item {
+                                width: parent.width - 135
+                                height: 1
+                            }
+
+                            // stress test toggle switch
+                            Rectangle {
+                                width: 40
+                                height: 20
+                                radius: 13
+                                color: stressToggleSwitch.checked ? "#0ea5e9" : "#2d3139"
+                                border.color: stressToggleSwitch.checked ? "#0284c7" : "#1e293b"
+                                border.width: 1
+                                anchors.verticalCenter: parent.verticalCenter
+
+                                Behavior on color {
+                                    ColorAnimation { duration: 200 }
+                                }
+
+                                Rectangle {
+                                    width: 18
+                                    height: 18
+                                    radius: 10
+                                    color: "#e5e5e5"
+                                    x: stressToggleSwitch.checked ? parent.width - width - 3 : 3
+                                    anchors.verticalCenter: parent.verticalCenter
+
+                                    Behavior on x {
+                                        NumberAnimation { duration: 200; easing.type: Easing.InOutQuad }
+                                    }
+                                }
+
+                                MouseArea {
+                                    id: stressToggleSwitch
+                                    anchors.fill: parent
+                                    cursorShape: Qt.PointingHandCursor
+                                    property bool checked: false
+
+                                    onClicked: {
+                                        checked = !checked
+                                    }
+                                }
+                            }
+                        }
+                    }
+
                     // divider line
                     Rectangle {
                         width: parent.width - 20
@@ -893,528 +1169,627 @@ ApplicationWindow  {
 
 
 
-                // equity curve and metrics results area
-                Rectangle {
-                     id: resultsArea
-                     anchors.fill: parent
-                     visible: opacity > 0
-                     opacity: (window.simulationMetrics !== null && !window.isTransitioning) ? 1 : 0
-                     color: "transparent"
+                // equity curve and metrics results area, built once the first results arrive
+                Loader {
+                    id: resultsLoader
+                    anchors.fill: parent
+                    active: window.dashboardRequested
+                    asynchronous: true
+                    visible: opacity > 0
+                    opacity: (window.simulationMetrics !== null && !window.isTransitioning) ? 1 : 0
 
 
-                     Behavior on opacity {
-                         NumberAnimation { duration: 500; easing.type: Easing.InOutQuad }
-                     }
+                    Behavior on opacity {
+                        NumberAnimation { duration: 500; easing.type: Easing.InOutQuad }
+                    }
 
+                    sourceComponent: Rectangle {
+                        id: resultsArea
+                        color: "transparent"
 
-                     RowLayout {
-                         id:resultsRow
-                         anchors.fill: parent
-                         spacing: 5
-
-                         // equity curve area
-                         Rectangle {
-                             id: equityCurveContainer
-                             Layout.fillWidth: true
-                             Layout.fillHeight: true
-                             Layout.margins: 10
-                             color: "transparent"
-
-                             ColumnLayout {
-                                 anchors.fill: parent
-                                 Layout.margins: 10
-                                 spacing: 15
-
-                                 RowLayout {
-                                    Layout.fillWidth: true
-                                    Layout.preferredHeight: 30
-                                    Layout.margins: 5
-
-                                     Text {
-                                         id: titleText
-                                         text: "Equity Curves - Monte Carlo Simulation"
-                                         color: "#B3FFFFFF"
-                                         font.pixelSize: 14
-                                         font.weight: Font.Medium
-                                         verticalAlignment: Text.AlignVCenter
-                                     }
-
-                                     Item {
-                                          Layout.fillWidth: true
-                                     }
-
-                                     RowLayout {
-                                         id: legendGroup
-                                         spacing: 20
-
-                                         Row {
-                                             spacing: 6
-
-                                             Rectangle {
-                                                 width: 30
-                                                 height: 5
-                                                 color: "#06b6d4"
-                                                 anchors.verticalCenter: parent.verticalCenter
-                                             }
-
-                                             Text {
-                                                 text: "Median"
-                                                 color: "#94a3b8"
-                                                 font.pixelSize: 12
-                                                 anchors.verticalCenter: parent.verticalCenter
-                                             }
-                                         }
-
-                                         Row {
-                                             spacing: 6
-
-                                             Rectangle {
-                                                 width: 30
-                                                 height: 5
-                                                 color: "#ec4899"
-                                                 anchors.verticalCenter: parent.verticalCenter
-                                             }
-
-                                             Text {
-                                                 text: Math.round(confidenceLevelSlider.value) + "% CL"
-                                                 color: "#94a3b8"
-                                                 font.pixelSize: 12
-                                                 anchors.verticalCenter: parent.verticalCenter
-                                             }
-                                         }
-
-                                         Row {
-                                             spacing: 6
-
-                                             Rectangle {
-                                                 width: 30
-                                                 height: 5
-                                                 color: "#7b68ee"
-                                                 anchors.verticalCenter: parent.verticalCenter
-                                             }
-
-                                             Text {
-                                                 text: "Runs"
-                                                 color: "#94a3b8"
-                                                 font.pixelSize: 12
-                                                 anchors.verticalCenter: parent.verticalCenter
-                                             }
-                                         }
-                                     }
-                                 }
-
-                 Rectangle {
-                     id:equityCurveGraphArea
-                     color: "#151822"
-                     border.color: "#2d3139"
-                     radius: 5
-                     Layout.fillWidth: true
-                     Layout.fillHeight: true
-
-                     GraphsView {
-                             id: graphView
-                             anchors.fill: parent
-                             anchors.margins: 20
-                             anchors.bottomMargin: 20
-                             anchors.leftMargin: 50
-
-                             theme: GraphsTheme {
-                                 theme: GraphsTheme.Theme.UserDefined
-                                 colorScheme: GraphsTheme.ColorScheme.Dark
-                                 backgroundColor: "#151822"
-                                 grid.mainColor: "#1e2531"
-                                 grid.subColor: "transparent"
-                                 labelTextColor: "#64748b"
-                                 plotAreaBackgroundColor: "#151822"
-                                 gridVisible: true
-                             }
-
-                             axisX: ValueAxis {
-                                 id: axisX
-                                 min: 0
-                                 max: 100
-                                 labelFormat: "%.0f"
-                             }
-
-                             axisY: ValueAxis {
-                                 id: axisY
-                                 min: 0
-                                 max: 10000
-                                 labelFormat: "$%.0f"
-                             }
-
-                             // sample runs
-                             SplineSeries {
-                             id: sample0;
-                             color: "#7b68ee";
-                             width: 1;
-                             opacity: 0.6
-                             }
-
-                             SplineSeries {
-                             id: sample1;
-                             color: "#7b68ee";
-                             width: 1;
-                             opacity: 0.6
-                             }
-
-                             SplineSeries {
-                             id: sample2;
-                             color: "#7b68ee";
-                             width: 1;
-                             opacity: 0.6
-                             }
-
-                             SplineSeries {
-                             id: sample3;
-                             color: "#7b68ee";
-                             width: 1;
-                             opacity: 0.6
-                             }
-
-                             SplineSeries {
-                             id: sample4;
-                             color: "#7b68ee";
-                             width: 1;
-                             opacity: 0.6
-                             }
-
-                             SplineSeries {
-                             id: confidenceSeries
-                             color: "#ec4899"
-                             width: 2
-                             name: "Confidence"
-                             }
-
-                             SplineSeries {
-                             id: medianSeries
-                             color: "#06b6d4"
-                             width: 3
-                             name: "Median"
-                             }
-                          }
-
-                     Text {
-                         text: "Equity ($)"
-                         color: "#64748b"
-                         font.pixelSize: 12
-                         rotation: -90
-                         anchors.left: parent.left
-                         anchors.verticalCenter: parent.verticalCenter
-                         anchors.leftMargin: 15
-                         transformOrigin: Item.Center
-                     }
+                        Component.onCompleted: showMetrics(window.simulationMetrics)
 
-                     Text {
-                         text: "Trades"
-                         color: "#64748b"
-                         font.pixelSize: 12
-                         anchors.bottom: parent.bottom
-                         anchors.horizontalCenter: parent.horizontalCenter
-                         anchors.bottomMargin: 10
-                     }
-                 }
-             }
-         }
-
-                 // metrics tab
-                 Rectangle {
-                     id: rightMetricsPanel
-                     Layout.preferredWidth: 350
-                     Layout.fillHeight: true
-                     Layout.margins: 10
-                     color: "transparent"
-
-                     ColumnLayout {
-                         anchors.fill: parent
-                         spacing: 10
-
-                         Text {
-                             text: "Simulation Results"
-                             color: "#B3FFFFFF"
-                             font.pixelSize: 14
-                             font.weight: Font.Medium
-                             Layout.topMargin: 10
-                             Layout.leftMargin: 10
-                         }
+                        Connections {
+                            target: window
+                            function onSimulationMetricsChanged() {
+                                resultsArea.showMetrics(window.simulationMetrics)
+                            }
+                        }
 
+                        function showMetrics(metrics) {
+                            if (metrics === null) {
+                                clearGraphData()
+                                return
+                            }
 
-                         RowLayout {
-                             id: tabBar
-                             spacing: 10
-                             Layout.fillWidth: true
-                             Layout.leftMargin: 10
-
-                             ButtonGroup { id: tabGroup } //only one tab button must be active at a time
-
-                             Repeater {
-                                 model: ["Overview", "Returns", "Risk", "Trades"]
-
-                                 delegate: RadioButton {
-                                     text: modelData
-                                     ButtonGroup.group: tabGroup
-                                     checked: index === 0
-                                     indicator.visible: false
-
-                                     contentItem: Text {
-                                         text: parent.text
-                                         font.pixelSize: 13
-                                         font.weight: Font.Medium
-                                         color: parent.checked ? "#ffffff" : "#94a3b8"
-                                         horizontalAlignment: Text.AlignHCenter
-                                         verticalAlignment: Text.AlignVCenter
-                                     }
-
-                                     background: Rectangle {
-                                         visible: parent.checked
-                                         color: "transparent"
-                                         radius: 15
-                                         implicitWidth: 80
-                                         implicitHeight: 30
-
-                                         gradient: Gradient {
-                                             GradientStop {
-                                                 position: 0.0
-                                                 color: parent.hovered ? "#06b6d4" : "#0ea5e9"
-                                             }
-                                             GradientStop {
-                                                 position: 1.0
-                                                 color: parent.hovered ? "#0284c7" : "#0369a1"
-                                             }
-                                         }
-
-                                         Rectangle {
-                                             anchors.fill: parent
-                                             radius: parent.radius
-                                             gradient: Gradient {
-                                                 GradientStop { position: 0.0; color: "#20FFFFFF" }
-                                                 GradientStop { position: 0.5; color: "#00FFFFFF" }
-                                             }
-                                         }
-
-                                         border.color: "#22d3ee"
-                                         border.width: 1
-                                     }
-                                 }
-                             }
-                         }
+                            // update axes
+                            var range = metrics.maxY - metrics.minY
+                            var buffer = range * 0.05
+                            axisY.min = Math.max(0, metrics.minY - buffer)
+                            axisY.max = metrics.maxY + buffer
+                            axisX.max = metrics.maxX
+
+                            populateSeries(medianSeries, metrics.medianCurve)
+                            populateSeries(confidenceSeries, metrics.confidenceCurve)
+
+                            populateSeries(sample0, metrics.sampleCurve0)
+                            populateSeries(sample1, metrics.sampleCurve1)
+                            populateSeries(sample2, metrics.sampleCurve2)
+                            populateSeries(sample3, metrics.sampleCurve3)
+                            populateSeries(sample4, metrics.sampleCurve4)
+                        }
 
+                        function populateSeries(seriesObj, dataPoints) {
+                            seriesObj.clear()
 
-                         StackLayout {
-                             id: tabContent
-                             Layout.fillWidth: true
-                             Layout.fillHeight: true
-                             currentIndex: tabGroup.checkedButton ? tabGroup.buttons.indexOf(tabGroup.checkedButton) : 0
-
-
-                                 ColumnLayout {
-                                     id: overviewLayout
-                                     Layout.fillWidth: true
-                                     Layout.fillHeight: true
-                                     spacing: 8
-
-                                     MetricCard {
-                                         title: "Simulations Run"
-                                         value: window.simulationMetrics ? window.simulationMetrics.numSimulations.toString() : "0"
-                                         valueColor: "#8b5cf6"
-                                         iconSource: "qrc:/assets/icons/simulation_metric_icon.svg"
-                                     }
-
-                                     MetricCard {
-                                         title: "Median Return"
-                                         value: window.simulationMetrics ? formatPercent(window.simulationMetrics.medianReturn, 2, true) : "+0.00%"
-                                         valueColor: window.simulationMetrics && window.simulationMetrics.medianReturn > 0 ? "#10b981" : "#ef4444"
-                                         iconSource: "qrc:/assets/icons/median_return_icon.svg"
-                                     }
-
-                                     MetricCard {
-                                         title: "Median Max Drawdown"
-                                         value: window.simulationMetrics ? "-" + window.simulationMetrics.medianMaxDrawdown.toFixed(1) + "%" : "-0.0%"
-                                         valueColor: "#f59e0b"
-                                         iconSource: "qrc:/assets/icons/median_max_dd.svg"
-                                     }
-
-                                     MetricCard {
-                                         title: "Sharpe Ratio (Median)"
-                                         value: window.simulationMetrics ? window.simulationMetrics.medianSharpeRatio.toFixed(2) : "0.00"
-                                         valueColor: "#f59e0b"
-                                         iconSource: "qrc:/assets/icons/sharpe_ratio_metric_icon.svg"
-                                     }
-
-                                     MetricCard {
-                                         title: "Risk of Ruin"
-                                         value: window.simulationMetrics ? window.simulationMetrics.riskOfRuin.toFixed(2) + "%" : "0.00%"
-                                         valueColor: window.simulationMetrics && window.simulationMetrics.riskOfRuin < 1 ? "#10b981" : "#ef4444"
-                                         iconSource: "qrc:/assets/icons/risk_of_ruin_icon.svg"
-                                     }
-
-                                     MetricCard {
-                                         title: "Calmar Ratio"
-                                         value: window.simulationMetrics ? window.simulationMetrics.medianCalmarRatio.toFixed(2) : "0.00"
-                                         valueColor: "#8b5cf6"
-                                         iconSource: "qrc:/assets/icons/calmar_ratio.svg"
-                                     }
-                                 }
-
-
-
-                                 ColumnLayout {
-                                     id: returnsColumn
-                                     Layout.fillWidth: true
-                                     Layout.fillHeight: true
-                                     spacing: 8
-
-                                     MetricCard {
-                                         title: "Median Return"
-                                         value: window.simulationMetrics ? formatPercent(window.simulationMetrics.medianReturn, 2, true) : "+0.00%"
-                                         valueColor: window.simulationMetrics && window.simulationMetrics.medianReturn > 0 ? "#10b981" : "#ef4444"
-                                         iconSource: "qrc:/assets/icons/percent_icon.svg"
-                                     }
-
-                                     MetricCard {
-                                         title: "Mean Return"
-                                         value: window.simulationMetrics ? formatPercent(window.simulationMetrics.meanReturn, 2, true) : "+0.00%"
-                                         valueColor: window.simulationMetrics && window.simulationMetrics.meanReturn > 0 ? "#10b981" : "#ef4444"
-                                         iconSource: "qrc:/assets/icons/percent_icon.svg"
-                                     }
-
-                                     MetricCard {
-                                         title: "Best Case (99th %ile)"
-                                         value: window.simulationMetrics ? "+" + window.simulationMetrics.bestReturn.toFixed(1) + "%" : "+0.0%"
-                                         valueColor: "#10b981"
-                                         iconSource: "qrc:/assets/icons/percent_icon.svg"
-                                     }
-
-                                     MetricCard {
-                                         title: "Worst Case (1st %ile)"
-                                         value: window.simulationMetrics ? window.simulationMetrics.worstReturn.toFixed(1) + "%" : "0.0%"
-                                         valueColor: "#ef4444"
-                                         iconSource: "qrc:/assets/icons/trending_down_red_icon.svg"
-                                     }
-
-                                     MetricCard {
-                                         title: "Profit Factor (Median)"
-                                         value: window.simulationMetrics ? window.simulationMetrics.medianProfitFactor.toFixed(2) : "0.00"
-                                         valueColor: "#0ea5e9"
-                                         iconSource: "qrc:/assets/icons/profit_factor_trending_up.svg"
-                                     }
-
-                                     MetricCard {
-                                         title: "Sharpe Ratio (Median)"
-                                         value: window.simulationMetrics ? window.simulationMetrics.medianSharpeRatio.toFixed(2) : "0.00"
-                                         valueColor: "#f59e0b"
-                                         iconSource: "qrc:/assets/icons/sharpe_ratio_metric_icon.svg"
-                                     }
-                                 }
-
-
-
-
-                                 ColumnLayout {
-                                     id: riskColumn
-                                     Layout.fillWidth: true
-                                     Layout.fillHeight: true
-                                     spacing: 8
-
-                                     MetricCard {
-                                         title: "Median Max Drawdown"
-                                         value: window.simulationMetrics ? "-" + window.simulationMetrics.medianMaxDrawdown.toFixed(1) + "%" : "-0.0%"
-                                         valueColor: "#f59e0b"
-                                         iconSource: "qrc:/assets/icons/median_max_dd.svg"
-                                     }
-
-                                     MetricCard {
-                                         title: "Best Case Max Drawdown"
-                                         value: window.simulationMetrics ? "-" + window.simulationMetrics.bestMaxDrawdown.toFixed(1) + "%" : "-0.0%"
-                                         valueColor: "#10b981"
-                                         iconSource: "qrc:/assets/icons/best_case_dd.svg"
-                                     }
-
-                                     MetricCard {
-                                         title: "Worst Case Max Drawdown (95th %ile)"
-                                         value: window.simulationMetrics ? "-" + window.simulationMetrics.worstMaxDrawdown.toFixed(1) + "%" : "-0.0%"
-                                         valueColor: "#ef4444"
-                                         iconSource: "qrc:/assets/icons/trending_down_red_icon.svg"
-                                     }
-
-                                     MetricCard {
-                                         title: "Value at Risk (95%)"
-                                         value: window.simulationMetrics ? window.simulationMetrics.valueAtRisk95.toFixed(1) + "%" : "0.0%"
-                                         valueColor: "#ef4444"
-                                         iconSource: "qrc:/assets/icons/worst_case_icon.svg"
-                                     }
-
-                                     MetricCard {
-                                         title: "Risk of Ruin"
-                                         value: window.simulationMetrics ? window.simulationMetrics.riskOfRuin.toFixed(2) + "%" : "0.00%"
-                                         valueColor: window.simulationMetrics && window.simulationMetrics.riskOfRuin < 1 ? "#10b981" : "#ef4444"
-                                         iconSource: "qrc:/assets/icons/worst_case_icon.svg"
-                                     }
-
-                                     MetricCard {
-                                         title: "Calmar Ratio (Median)"
-                                         value: window.simulationMetrics ? window.simulationMetrics.medianCalmarRatio.toFixed(2) : "0.00"
-                                         valueColor: "#8b5cf6"
-                                         iconSource: "qrc:/assets/icons/calmar_ratio.svg"
-                                     }
-                                 }
-
-
-
-                                 ColumnLayout {
-                                     id: tradesColumn
-                                     Layout.fillWidth: true
-                                     Layout.fillHeight: true
-                                     spacing: 8
-
-                                     MetricCard {
-                                         title: "Total Trades"
-                                         value: window.simulationMetrics ? window.simulationMetrics.totalTrades.toString() : "0"
-                                         valueColor: "#8b5cf6"
-                                         iconSource: "qrc:/assets/icons/total_trade_metric_icon.svg"
-                                     }
-
-                                     MetricCard {
-                                         title: "Win Rate (Median)"
-                                         value: window.simulationMetrics ? window.simulationMetrics.medianWinRate.toFixed(0) + "%" : "0%"
-                                         valueColor: "#10b981"
-                                         iconSource: "qrc:/assets/icons/target_green_icon.svg"
-                                     }
-
-                                     MetricCard {
-                                         title: "Avg R/R Ratio"
-                                         value: window.simulationMetrics ? window.simulationMetrics.avgRiskReward.toFixed(1) : "0.0"
-                                         valueColor: "#06b6d4"
-                                         iconSource: "qrc:/assets/icons/avg_rr_icon.svg"
-                                     }
-
-                                     MetricCard {
-                                         title: "Expectancy per Trade"
-                                         value: window.simulationMetrics ? formatCurrency(window.simulationMetrics.expectancyPerTrade, 0, true) : "$0"
-                                         valueColor: window.simulationMetrics && window.simulationMetrics.expectancyPerTrade > 0 ? "#10b981" : "#ef4444"
-                                         iconSource: "qrc:/assets/icons/arrow_outward_icon.svg"
-                                     }
-
-                                     MetricCard {
-                                         title: "Avg Loss"
-                                         value: window.simulationMetrics ? "-$" + window.simulationMetrics.avgLoss.toFixed(0) : "-$0"
-                                         valueColor: "#ef4444"
-                                         iconSource: "qrc:/assets/icons/worst_case_icon.svg"
-                                     }
-
-                                     MetricCard {
-                                         title: "Largest Win"
-                                         value: window.simulationMetrics ? "+$" + window.simulationMetrics.largestWin.toFixed(0) : "+$0"
-                                         valueColor: "#10b981"
-                                         iconSource: "qrc:/assets/icons/arrow_outward_icon.svg"
-                                     }
-                                 }
+                            if (dataPoints && dataPoints.length > 0) {
+                                seriesObj.visible = true
+                                for (var i = 0; i < dataPoints.length; i++) {
+                                    seriesObj.append(dataPoints[i].x, dataPoints[i].y)
+                                }
+                            } else {
+                                seriesObj.visible = false
+                            }
+                        }
 
-                         }
-                     }
+                        function clearGraphData() {
+                            medianSeries.clear()
+                            confidenceSeries.clear()
+                            sample0.clear()
+                            sample1.clear()
+                            sample2.clear()
+                            sample3.clear()
+                            sample4.clear()
+                        }
+
+
+                        RowLayout {
+                            id:resultsRow
+                            anchors.fill: parent
+                            spacing: 5
+
+                            // equity curve area
+                            Rectangle {
+                                id: equityCurveContainer
+                                Layout.fillWidth: true
+                                Layout.fillHeight: true
+                                Layout.margins: 10
+                                color: "transparent"
+
+                                ColumnLayout {
+                                    anchors.fill: parent
+                                    Layout.margins: 10
+                                    spacing: 15
+
+                                    RowLayout {
+                                        Layout.fillWidth: true
+                                        Layout.preferredHeight: 30
+                                        Layout.margins: 5
+
+                                        Text {
+                                            id: titleText
+                                            text: "Equity Curves - Monte Carlo Simulation"
+                                            color: "#B3FFFFFF"
+                                            font.pixelSize: 14
+                                            font.weight: Font.Medium
+                                            verticalAlignment: Text.AlignVCenter
+                                        }
+
+                                        Item {
+                                            Layout.fillWidth: true
+                                        }
+
+                                        RowLayout {
+                                            id: legendGroup
+                                            spacing: 20
+
+                                            Row {
+                                                spacing: 6
+
+                                                Rectangle {
+                                                    width: 30
+                                                    height: 5
+                                                    color: "#06b6d4"
+                                                    anchors.verticalCenter: parent.verticalCenter
+                                                }
+
+                                                Text {
+                                                    text: "Median"
+                                                    color: "#94a3b8"
+                                                    font.pixelSize: 12
+                                                    anchors.verticalCenter: parent.verticalCenter
+                                                }
+                                            }
+
+                                            Row {
+                                                spacing: 6
+
+                                                Rectangle {
+                                                    width: 30
+                                                    height: 5
+                                                    color: "#ec4899"
+                                                    anchors.verticalCenter: parent.verticalCenter
+                                                }
+
+                                                Text {
+                                                    text: Math.round(confidenceLevelSlider.value) + "% CL"
+                                                    color: "#94a3b8"
+                                                    font.pixelSize: 12
+                                                    anchors.verticalCenter: parent.verticalCenter
+                                                }
+                                            }
+
+                                            Row {
+                                                spacing: 6
+
+                                                Rectangle {
+                                                    width: 30
+                                                    height: 5
+                                                    color: "#7b68ee"
+                                                    anchors.verticalCenter: parent.verticalCenter
+                                                }
+
+                                                Text {
+                                                    text: "Runs"
+                                                    color: "#94a3b8"
+                                                    font.pixelSize: 12
+                                                    anchors.verticalCenter: parent.verticalCenter
+                                                }
+                                            }
+                                        }
+                                    }
+
+                                    Rectangle {
+                                        id:equityCurveGraphArea
+                                        color: "#151822"
+                                        border.color: "#2d3139"
+                                        radius: 5
+                                        Layout.fillWidth: true
+                                        Layout.fillHeight: true
+
+                                        GraphsView {
+                                            id: graphView
+                                            anchors.fill: parent
+                                            anchors.margins: 20
+                                            anchors.bottomMargin: 20
+                                            anchors.leftMargin: 50
+
+                                            theme: GraphsTheme {
+                                                theme: GraphsTheme.Theme.UserDefined
+                                                colorScheme: GraphsTheme.ColorScheme.Dark
+                                                backgroundColor: "#151822"
+                                                grid.mainColor: "#1e2531"
+                                                grid.subColor: "transparent"
+                                                labelTextColor: "#64748b"
+                                                plotAreaBackgroundColor: "#151822"
+                                                gridVisible: true
+                                            }
+
+                                            axisX: ValueAxis {
+                                                id: axisX
+                                                min: 0
+                                                max: 100
+                                                labelFormat: "%.0f"
+                                            }
+
+                                            axisY: ValueAxis {
+                                                id: axisY
+                                                min: 0
+                                                max: 10000
+                                                labelFormat: "$%.0f"
+                                            }
+
+                                            // sample runs
+                                            SplineSeries {
+                                                id: sample0;
+                                                color: "#7b68ee";
+                                                width: 1;
+                                                opacity: 0.6
+                                            }
+
+                                            SplineSeries {
+                                                id: sample1;
+                                                color: "#7b68ee";
+                                                width: 1;
+                                                opacity: 0.6
+                                            }
+
+                                            SplineSeries {
+                                                id: sample2;
+                                                color: "#7b68ee";
+                                                width: 1;
+                                                opacity: 0.6
+                                            }
+
+                                            SplineSeries {
+                                                id: sample3;
+                                                color: "#7b68ee";
+                                                width: 1;
+                                                opacity: 0.6
+                                            }
+
+                                            SplineSeries {
+                                                id: sample4;
+                                                color: "#7b68ee";
+                                                width: 1;
+                                                opacity: 0.6
+                                            }
+
+                                            SplineSeries {
+                                                id: confidenceSeries
+                                                color: "#ec4899"
+                                                width: 2
+                                                name: "Confidence"
+                                            }
+
+                                            SplineSeries {
+                                                id: medianSeries
+                                                color: "#06b6d4"
+                                                width: 3
+                                                name: "Median"
+                                            }
+                                        }
+
+                                        Text {
+                                            text: "Equity ($)"
+                                            color: "#64748b"
+                                            font.pixelSize: 12
+                                            rotation: -90
+                                            anchors.left: parent.left
+                                            anchors.verticalCenter: parent.verticalCenter
+                                            anchors.leftMargin: 15
+                                            transformOrigin: Item.Center
+                                        }
+
+                                        Text {
+                                            text: "Trades"
+                                            color: "#64748b"
+                                            font.pixelSize: 12
+                                            anchors.bottom: parent.bottom
+                                            anchors.horizontalCenter: parent.horizontalCenter
+                                            anchors.bottomMargin: 10
+                                        }
+                                    }
+                                }
+                            }
+
+                            // metrics tab
+                            Rectangle {
+                                id: rightMetricsPanel
+                                Layout.preferredWidth: 350
+                                Layout.fillHeight: true
+                                Layout.margins: 10
+                                color: "transparent"
+
+                                ColumnLayout {
+                                    anchors.fill: parent
+                                    spacing: 10
+
+                                    Text {
+                                        text: "Simulation Results"
+                                        color: "#B3FFFFFF"
+                                        font.pixelSize: 14
+                                        font.weight: Font.Medium
+                                        Layout.topMargin: 10
+                                        Layout.leftMargin: 10
+                                    }
+
+
+                                    RowLayout {
+                                        id: tabBar
+                                        spacing: 10
+                                        Layout.fillWidth: true
+                                        Layout.leftMargin: 10
+
+                                        ButtonGroup { id: tabGroup } //only one tab button must be active at a time
+
+                                        Repeater {
+                                            model: ["Overview", "Returns", "Risk", "Trades"]
+
+                                            delegate: RadioButton {
+                                                text: modelData
+                                                ButtonGroup.group: tabGroup
+                                                checked: index === 0
+                                                indicator.visible: false
+
+                                                contentItem: Text {
+                                                    text: parent.text
+                                                    font.pixelSize: 13
+                                                    font.weight: Font.Medium
+                                                    color: parent.checked ? "#ffffff" : "#94a3b8"
+                                                    horizontalAlignment: Text.AlignHCenter
+                                                    verticalAlignment: Text.AlignVCenter
+                                                }
+
+                                                background: Rectangle {
+                                                    visible: parent.checked
+                                                    color: "transparent"
+                                                    radius: 15
+                                                    implicitWidth: 80
+                                                    implicitHeight: 30
+
+                                                    gradient: Gradient {
+                                                        GradientStop {
+                                                            position: 0.0
+                                                            color: parent.hovered ? "#06b6d4" : "#0ea5e9"
+                                                        }
+                                                        GradientStop {
+                                                            position: 1.0
+                                                            color: parent.hovered ? "#0284c7" : "#0369a1"
+                                                        }
+                                                    }
+
+                                                    Rectangle {
+                                                        anchors.fill: parent
+                                                        radius: parent.radius
+                                                        gradient: Gradient {
+                                                            GradientStop { position: 0.0; color: "#20FFFFFF" }
+                                                            GradientStop { position: 0.5; color: "#00FFFFFF" }
+                                                        }
+                                                    }
+
+                                                    border.color: "#22d3ee"
+                                                    border.width: 1
+                                                }
+                                            }
+                                        }
+                                    }
+
+
+                                    StackLayout {
+                                        id: tabContent
+                                        Layout.fillWidth: true
+                                        Layout.fillHeight: true
+                                        currentIndex: tabGroup.checkedButton ? tabGroup.buttons.indexOf(tabGroup.checkedButton) : 0
+
+                                        // one bit per tab, latched the first time it is shown
+                                        property int shownTabs: 0
+                                        onCurrentIndexChanged: shownTabs |= 1 << currentIndex
+                                        Component.onCompleted: shownTabs |= 1 << currentIndex
+
+
+                                        // a tab is built the first time it is shown and kept afterwards
+                                        Loader {
+                                            active: (tabContent.shownTabs & (1 << 0)) !== 0
+                                            sourceComponent: ColumnLayout {
+                                                id: overviewLayout
+                                                Layout.fillWidth: true
+                                                Layout.fillHeight: true
+                                                spacing: 8
+
+                                                MetricCard {
+                                                    title: "Simulations Run"
+                                                    value: !window.simulationMetrics ? "0"
+                                                           : window.simulationMetrics.samplingMode > 0
+                                                             ? window.simulationMetrics.numSimulations + " (" + Math.round(window.simulationMetrics.effectiveSampleSize) + " eff.)"
+                                                             : window.simulationMetrics.numSimulations.toString()
+                                                    valueColor: "#8b5cf6"
+                                                    iconSource: "qrc:/assets/icons/simulation_metric_icon.svg"
+                                                }
+
+                                                MetricCard {
+                                                    title: "Median Return"
+                                                    value: window.simulationMetrics ? formatPercent(window.simulationMetrics.medianReturn, 2, true) : "+0.00%"
+                                                    valueColor: window.simulationMetrics && window.simulationMetrics.medianReturn > 0 ? "#10b981" : "#ef4444"
+                                                    iconSource: "qrc:/assets/icons/median_return_icon.svg"
+                                                }
+
+                                                MetricCard {
+                                                    title: "Median Max Drawdown"
+                                                    value: window.simulationMetrics ? "-" + window.simulationMetrics.medianMaxDrawdown.toFixed(1) + "%" : "-0.0%"
+                                                    valueColor: "#f59e0b"
+                                                    iconSource: "qrc:/assets/icons/median_max_dd.svg"
+                                                }
+
+                                                MetricCard {
+                                                    title: "Sharpe Ratio (Median)"
+                                                    value: window.simulationMetrics ? window.simulationMetrics.medianSharpeRatio.toFixed(2) : "0.00"
+                                                    valueColor: "#f59e0b"
+                                                    iconSource: "qrc:/assets/icons/sharpe_ratio_metric_icon.svg"
+                                                }
+
+                                                MetricCard {
+                                                    title: "Risk of Ruin"
+                                                    value: window.simulationMetrics ? window.simulationMetrics.riskOfRuin.toFixed(2) + "%" : "0.00%"
+                                                    valueColor: window.simulationMetrics && window.simulationMetrics.riskOfRuin < 1 ? "#10b981" : "#ef4444"
+                                                    iconSource: "qrc:/assets/icons/risk_of_ruin_icon.svg"
+                                                }
+
+                                                MetricCard {
+                                                    title: "Calmar Ratio"
+                                                    value: window.simulationMetrics ? window.simulationMetrics.medianCalmarRatio.toFixed(2) : "0.00"
+                                                    valueColor: "#8b5cf6"
+                                                    iconSource: "qrc:/assets/icons/calmar_ratio.svg"
+                                                }
+                                            }
+                                        }
+
+
+
+                                        Loader {
+                                            active: (tabContent.shownTabs & (1 << 1)) !== 0
+                                            sourceComponent: ColumnLayout {
+                                                id: returnsColumn
+                                                Layout.fillWidth: true
+                                                Layout.fillHeight: true
+                                                spacing: 8
+
+                                                MetricCard {
+                                                    title: "Median Return"
+                                                    value: window.simulationMetrics ? formatPercent(window.simulationMetrics.medianReturn, 2, true) : "+0.00%"
+                                                    valueColor: window.simulationMetrics && window.simulationMetrics.medianReturn > 0 ? "#10b981" : "#ef4444"
+                                                    iconSource: "qrc:/assets/icons/percent_icon.svg"
+                                                }
+
+                                                MetricCard {
+                                                    title: "Mean Return"
+                                                    value: window.simulationMetrics ? formatPercent(window.simulationMetrics.meanReturn, 2, true) : "+0.00%"
+                                                    valueColor: window.simulationMetrics && window.simulationMetrics.meanReturn > 0 ? "#10b981" : "#ef4444"
+                                                    iconSource: "qrc:/assets/icons/percent_icon.svg"
+                                                }
+
+                                                MetricCard {
+                                                    title: "Best Case (99th %ile)"
+                                                    value: window.simulationMetrics ? "+" + window.simulationMetrics.bestReturn.toFixed(1) + "%" : "+0.0%"
+                                                    valueColor: "#10b981"
+                                                    iconSource: "qrc:/assets/icons/percent_icon.svg"
+                                                }
+
+                                                MetricCard {
+                                                    title: "Worst Case (1st %ile)"
+                                                    value: window.simulationMetrics ? window.simulationMetrics.worstReturn.toFixed(1) + "%" : "0.0%"
+                                                    valueColor: "#ef4444"
+                                                    iconSource: "qrc:/assets/icons/trending_down_red_icon.svg"
+                                                }
+
+                                                MetricCard {
+                                                    title: "Profit Factor (Median)"
+                                                    value: window.simulationMetrics ? window.simulationMetrics.medianProfitFactor.toFixed(2) : "0.00"
+                                                    valueColor: "#0ea5e9"
+                                                    iconSource: "qrc:/assets/icons/profit_factor_trending_up.svg"
+                                                }
+
+                                                MetricCard {
+                                                    title: "Sharpe Ratio (Median)"
+                                                    value: window.simulationMetrics ? window.simulationMetrics.medianSharpeRatio.toFixed(2) : "0.00"
+                                                    valueColor: "#f59e0b"
+                                                    iconSource: "qrc:/assets/icons/sharpe_ratio_metric_icon.svg"
+                                                }
+                                            }
+                                        }
+
+
+
+
+                                        Loader {
+                                            active: (tabContent.shownTabs & (1 << 2)) !== 0
+                                            sourceComponent: ColumnLayout {
+                                                id: riskColumn
+                                                Layout.fillWidth: true
+                                                Layout.fillHeight: true
+                                                spacing: 8
+
+                                                MetricCard {
+                                                    title: "Median Max Drawdown"
+                                                    value: window.simulationMetrics ? "-" + window.simulationMetrics.medianMaxDrawdown.toFixed(1) + "%" : "-0.0%"
+                                                    valueColor: "#f59e0b"
+                                                    iconSource: "qrc:/assets/icons/median_max_dd.svg"
+                                                }
+
+                                                MetricCard {
+                                                    title: "Best Case Max Drawdown"
+                                                    value: window.simulationMetrics ? "-" + window.simulationMetrics.bestMaxDrawdown.toFixed(1) + "%" : "-0.0%"
+                                                    valueColor: "#10b981"
+                                                    iconSource: "qrc:/assets/icons/best_case_dd.svg"
+                                                }
+
+                                                MetricCard {
+                                                    title: "Worst Case Max Drawdown (95th %ile)"
+                                                    value: window.simulationMetrics ? "-" + window.simulationMetrics.worstMaxDrawdown.toFixed(1) + "%" : "-0.0%"
+                                                    valueColor: "#ef4444"
+                                                    iconSource: "qrc:/assets/icons/trending_down_red_icon.svg"
+                                                }
+
+                                                MetricCard {
+                                                    title: "Value at Risk (95%)"
+                                                    value: window.simulationMetrics ? window.simulationMetrics.valueAtRisk95.toFixed(1) + "%" : "0.0%"
+                                                    valueColor: "#ef4444"
+                                                    iconSource: "qrc:/assets/icons/worst_case_icon.svg"
+                                                }
+
+                                                MetricCard {
+                                                    title: "Risk of Ruin"
+                                                    value: window.simulationMetrics ? window.simulationMetrics.riskOfRuin.toFixed(2) + "%" : "0.00%"
+                                                    valueColor: window.simulationMetrics && window.simulationMetrics.riskOfRuin < 1 ? "#10b981" : "#ef4444"
+                                                    iconSource: "qrc:/assets/icons/worst_case_icon.svg"
+                                                }
+
+                                                MetricCard {
+                                                    title: "Calmar Ratio (Median)"
+                                                    value: window.simulationMetrics ? window.simulationMetrics.medianCalmarRatio.toFixed(2) : "0.00"
+                                                    valueColor: "#8b5cf6"
+                                                    iconSource: "qrc:/assets/icons/calmar_ratio.svg"
+                                                }
+
+                                                // stressed replay of the same runs, only when the stress test was on
+                                                MetricCard {
+                                                    visible: window.simulationMetrics !== null && window.simulationMetrics.stressed !== undefined
+                                                    title: "Stressed Median Return"
+                                                    value: visible ? formatPercent(window.simulationMetrics.stressed.medianReturn, 2, true) : "+0.00%"
+                                                    valueColor: visible && window.simulationMetrics.stressed.medianReturn > 0 ? "#10b981" : "#ef4444"
+                                                    iconSource: "qrc:/assets/icons/median_return_icon.svg"
+                                                }
+
+                                                MetricCard {
+                                                    visible: window.simulationMetrics !== null && window.simulationMetrics.stressed !== undefined
+                                                    title: "Stressed Worst Max Drawdown (95th %ile)"
+                                                    value: visible ? "-" + window.simulationMetrics.stressed.worstMaxDrawdown.toFixed(1) + "%" : "-0.0%"
+                                                    valueColor: "#ef4444"
+                                                    iconSource: "qrc:/assets/icons/trending_down_red_icon.svg"
+                                                }
+                                            }
+                                        }
+
+
+
+                                        Loader {
+                                            active: (tabContent.shownTabs & (1 << 3)) !== 0
+                                            sourceComponent: ColumnLayout {
+                                                id: tradesColumn
+                                                Layout.fillWidth: true
+                                                Layout.fillHeight: true
+                                                spacing: 8
+
+                                                MetricCard {
+                                                    title: "Total Trades"
+                                                    value: window.simulationMetrics ? window.simulationMetrics.totalTrades.toString() : "0"
+                                                    valueColor: "#8b5cf6"
+                                                    iconSource: "qrc:/assets/icons/total_trade_metric_icon.svg"
+                                                }
+
+                                                MetricCard {
+                                                    title: "Win Rate (Median)"
+                                                    value: window.simulationMetrics ? window.simulationMetrics.medianWinRate.toFixed(0) + "%" : "0%"
+                                                    valueColor: "#10b981"
+                                                    iconSource: "qrc:/assets/icons/target_green_icon.svg"
+                                                }
+
+                                                MetricCard {
+                                                    title: "Avg R/R Ratio"
+                                                    value: window.simulationMetrics ? window.simulationMetrics.avgRiskReward.toFixed(1) : "0.0"
+                                                    valueColor: "#06b6d4"
+                                                    iconSource: "qrc:/assets/icons/avg_rr_icon.svg"
+                                                }
+
+                                                MetricCard {
+                                                    title: "Expectancy per Trade"
+                                                    value: window.simulationMetrics ? formatCurrency(window.simulationMetrics.expectancyPerTrade, 0, true) : "$0"
+                                                    valueColor: window.simulationMetrics && window.simulationMetrics.expectancyPerTrade > 0 ? "#10b981" : "#ef4444"
+                                                    iconSource: "qrc:/assets/icons/arrow_outward_icon.svg"
+                                                }
+
+                                                MetricCard {
+                                                    title: "Avg Loss"
+                                                    value: window.simulationMetrics ? "-$" + window.simulationMetrics.avgLoss.toFixed(0) : "-$0"
+                                                    valueColor: "#ef4444"
+                                                    iconSource: "qrc:/assets/icons/worst_case_icon.svg"
+                                                }
+
+                                                MetricCard {
+                                                    title: "Largest Win"
+                                                    value: window.simulationMetrics ? "+$" + window.simulationMetrics.largestWin.toFixed(0) : "+$0"
+                                                    valueColor: "#10b981"
+                                                    iconSource: "qrc:/assets/icons/arrow_outward_icon.svg"
+                                                }
+                                            }
+                                        }
+
+                                    }
+                                }
+                            }
+                        }
+                    }
                 }
-            }
-         }
     }
 
 }
@@ -1494,13 +1869,18 @@ ApplicationWindow  {
 
     FileDialog {
         id:fileDialog
-        title: "Open a XLSX file"
-        nameFilters: ["Excel files (*.xlsx)"]
+        title: "Open MT5 reports"
+        fileMode: FileDialog.OpenFiles
+        nameFilters: ["MT5 reports (*.xlsx *.csv *.htm *.html)", "Excel files (*.xlsx)", "CSV files (*.csv)", "HTML reports (*.htm *.html)"]
         currentFolder: StandardPaths.standardLocations(StandardPaths.DocumentsLocation)[0]
 
         onAccepted: {
-            var path = fileDialog.selectedFile.toString()
-            window.loadedFilePath = path
+            var paths = []
+            for (var i = 0; i < fileDialog.selectedFiles.length; i++) {
+                paths.push(fileDialog.selectedFiles[i].toString())
+            }
+            window.loadedFilePaths = paths
+            window.loadedFilePath = paths[0]
             window.fileLoaded = true
             window.simulationMetrics = null
 
@@ -1520,12 +1900,14 @@ ApplicationWindow  {
             Qt.callLater(function() {
                 window.simNumRuns = Math.round(numOfRunsSlider.value)
                 window.simRandomize = randomizeOrderToggleSwitch.checked
+                window.simDayBlocks = dayBlocksToggleSwitch.checked
+                window.simSampling = samplingModeSelector.mode
+                window.simStress = stressToggleSwitch.checked
                 // update ui state
                 window.simulationRunning = true
                 runButton.isSimulating = true
 
-                statusBarManager.setParsingFile(window.loadedFilePath)
-                excelParser.parseExcelFile(window.loadedFilePath)
+                startParsing()
             })
         }
     }
@@ -1538,84 +1920,134 @@ ApplicationWindow  {
                         var outcomes = excelParser.getTradeOutcomes()
                         var initialBal = excelParser.getInitialBalance()
 
-                        statusBarManager.setSimulating(window.simNumRuns)
+                        startSimulation(outcomes, [], initialBal)
+                    } else {
+                        statusBarManager.parsingComplete()
+                    }
+                }
+        }
 
-                        monteCarloSimulator.runSimulation(
-                            outcomes,
-                            initialBal,
-                            window.simNumRuns,
-                            window.simRandomize,
-                            confidenceLevelSlider.value
+    Connections {
+            target: portfolioLoader
+            function onLoadingComplete(initialBalance, tradeCount, reportCount) {
+                    if (window.simulationRunning) {
+                        // whole days are resampled so strategies keep their overlap, unless turned off
+                        startSimulation(
+                            portfolioLoader.getTradeOutcomes(),
+                            window.simDayBlocks ? portfolioLoader.getDayStarts() : [],
+                            portfolioLoader.getInitialBalance()
                         )
                     } else {
                         statusBarManager.parsingComplete()
                     }
                 }
+
+            function onLoadingFailed(error) {
+                runButton.isSimulating = false
+                window.simulationRunning = false
+                window.isTransitioning = false
+                statusBarManager.setError(error)
+            }
         }
 
     Connections {
             target: monteCarloSimulator
 
-            function onSimulationComplete(metrics) {
-                window.simulationMetrics = metrics
-                window.isTransitioning = false
-                runButton.isSimulating = false
-                window.simulationRunning = false
-                statusBarManager.simulationComplete(metrics.numSimulations)
-
-                // update axes
-                var range = metrics.maxY - metrics.minY
-                var buffer = range * 0.05
-                axisY.min = Math.max(0, metrics.minY - buffer)
-                axisY.max = metrics.maxY + buffer
-                axisX.max = metrics.maxX
-
-            function populateSeries(seriesObj, dataPoints) {
-                       seriesObj.clear()
-
-                       if (dataPoints && dataPoints.length > 0) {
-                           seriesObj.visible = true
-                           for (var i = 0; i < dataPoints.length; i++) {
-                               seriesObj.append(dataPoints[i].x, dataPoints[i].y)
-                           }
-                       } else {
-                           seriesObj.visible = false
-                       }
-                   }
-
-                populateSeries(medianSeries, metrics.medianCurve)
-                populateSeries(confidenceSeries, metrics.confidenceCurve)
-
-                populateSeries(sample0, metrics.sampleCurve0)
-                populateSeries(sample1, metrics.sampleCurve1)
-                populateSeries(sample2, metrics.sampleCurve2)
-                populateSeries(sample3, metrics.sampleCurve3)
-                populateSeries(sample4, metrics.sampleCurve4)
+            function onSimulationComplete(metrics) { handleSimulationComplete(metrics) }
+            function onSimulationFailed(error) { handleSimulationFailed(error) }
+            function onSimulationStopped() { handleSimulationStopped() }
+        }
 
+    Connections {
+            target: shardLauncher
+
+            function onSimulationComplete(metrics) { handleSimulationComplete(metrics) }
+            function onSimulationFailed(error) { handleSimulationFailed(error) }
+            function onSimulationStopped() { handleSimulationStopped() }
+        }
+
+    function handleSimulationComplete(metrics) {
+            window.dashboardRequested = true
+            window.simulationMetrics = metrics
+            window.isTransitioning = false
+            runButton.isSimulating = false
+            window.simulationRunning = false
+            statusBarManager.simulationComplete(metrics.numSimulations)
+        }
+
+    function handleSimulationFailed(error) {
+            runButton.isSimulating = false
+            window.simulationRunning = false
+            statusBarManager.setError(error)
+        }
+
+    function handleSimulationStopped() {
+            runButton.isSimulating = false
+            window.simulationRunning = false
+            statusBarManager.setIdle()
+        }
+
+    // jobs from shardedRunThreshold runs up are split across worker processes
+    function startSimulation(outcomes, blockStarts, initialBalance) {
+            statusBarManager.setSimulating(window.simNumRuns)
+            window.simSharded = window.simNumRuns >= window.shardedRunThreshold
+
+            var engine = window.simSharded ? shardLauncher : monteCarloSimulator
+            engine.setSamplingMode(window.simSampling)
+            applyStressScenario(engine)
+
+            if (window.simSharded) {
+                shardLauncher.runShardedSimulation(outcomes, initialBalance, window.simNumRuns,
+                                                   window.simRandomize, confidenceLevelSlider.value,
+                                                   0, blockStarts)
+            } else {
+                monteCarloSimulator.runBlockSimulation(outcomes, blockStarts, initialBalance, window.simNumRuns,
+                                                       window.simRandomize, confidenceLevelSlider.value)
             }
+        }
 
-            function onSimulationFailed(error) {
-                runButton.isSimulating = false
-                window.simulationRunning = false
-                statusBarManager.setError(error)
+    // missing or unreadable fields fall back to the preset: winners -10%, losers +10%,
+    // 5% of trades skipped, no cost, two 5-trade losing streaks
+    function applyStressScenario(engine) {
+            if (window.simStress) {
+                var preset = [10, 10, 5, 0, 2, 5]
+                var parts = stressScenarioInput.text.split(",")
+                var fields = []
+                for (var i = 0; i < preset.length; i++) {
+                    var value = i < parts.length ? parseFloat(parts[i]) : NaN
+                    fields.push(isNaN(value) ? preset[i] : value)
+                }
+                engine.setStressScenario(fields[0] / 100, fields[1] / 100, fields[2] / 100, fields[3],
+                                         Math.round(fields[4]), Math.round(fields[5]))
+            } else {
+                engine.setStressScenario(0, 0, 0, 0, 0, 0)
             }
+        }
 
-            function onSimulationStopped() {
-                runButton.isSimulating = false
-                window.simulationRunning = false
-                statusBarManager.setIdle()
+    // missing or unreadable weights count as 1
+    function basketWeights() {
+            var weights = []
+            var parts = basketWeightsInput.text.split(",")
+            for (var i = 0; i < parts.length; i++) {
+                var weight = parseFloat(parts[i])
+                weights.push(isNaN(weight) ? 1 : weight)
+            }
+            return basketWeightsInput.text.trim() === "" ? [] : weights
+        }
+
+    function startParsing() {
+            if (window.loadedFilePaths.length > 1) {
+                statusBarManager.setParsingFile(window.loadedFilePaths.length + " reports")
+                portfolioLoader.loadReports(window.loadedFilePaths, basketWeights())
+            } else {
+                statusBarManager.setParsingFile(window.loadedFilePath)
+                excelParser.parseExcelFile(window.loadedFilePath)
             }
         }
 
     function clearGraphData() {
-               if (typeof medianSeries !== "undefined") {
-                   medianSeries.clear()
-                   confidenceSeries.clear()
-                   sample0.clear()
-                   sample1.clear()
-                   sample2.clear()
-                   sample3.clear()
-                   sample4.clear()
+               if (resultsLoader.item) {
+                   resultsLoader.item.clearGraphData()
                }
         }
 
@@ -3,12 +3,78 @@
 #include <QVariantMap>
 #include <QVariantList>
 #include <algorithm>
+#include <array>
 #include <numeric>
 #include <cmath>
+#include <cstdint>
+#include <stdexcept>
+
+namespace {
+
+constexpr int kSampleCurveCount = 5;
+
+constexpr quint32 kPartialMagic = 0x4d435041; // "MCPA"
+constexpr quint32 kPartialVersion = 4;
+
+// stratified sampling: how many of the largest losses are placed, and into how many strata
+constexpr int kStratifiedLosses = 8;
+constexpr int kStrata = 16;
+
+// stress runs draw their random numbers batch by batch, one stream per kStressBatch runs
+constexpr int kStressBatch = 16;
+constexpr std::uint32_t kStressStream = 0x53545253; // "STRS"
+
+std::mt19937 runGenerator(quint64 seed, int run, std::uint32_t stream = 0)
+{
+    std::seed_seq runSeed{static_cast<std::uint32_t>(seed),
+                          static_cast<std::uint32_t>(seed >> 32),
+                          static_cast<std::uint32_t>(run), stream};
+    return std::mt19937(runSeed);
+}
+
+// latin hypercube strata for one placed loss: the kStrata runs of a cycle visit
+// each stratum once, run r taking strata[r % kStrata] of cycle r / kStrata
+std::array<int, kStrata> latinCycle(quint64 seed, int cycle, int loss)
+{
+    std::mt19937 cycleGenerator = runGenerator(seed, cycle, 1 + static_cast<std::uint32_t>(loss));
+    std::array<int, kStrata> strata;
+    std::iota(strata.begin(), strata.end(), 0);
+    std::shuffle(strata.begin(), strata.end(), cycleGenerator);
+    return strata;
+}
+
+QVector<QVector<double> *> metricColumns(MonteCarloSimulator::PartialAggregate &partial)
+{
+    return {
+        &partial.returns, &partial.maxDrawdowns, &partial.sharpeRatios,
+        &partial.profitFactors, &partial.calmarRatios, &partial.winRates,
+        &partial.riskRewards, &partial.avgLosses, &partial.finalBalances
+    };
+}
+
+void sortColumns(MonteCarloSimulator::PartialAggregate &partial)
+{
+    for (auto *column : metricColumns(partial)) {
+        std::sort(column->begin(), column->end());
+    }
+    for (auto &column : partial.stepBalances) {
+        std::sort(column.begin(), column.end());
+    }
+}
+
+void mergeSorted(QVector<double> &into, const QVector<double> &from)
+{
+    QVector<double> merged(into.size() + from.size());
+    std::merge(into.cbegin(), into.cend(), from.cbegin(), from.cend(), merged.begin());
+    into.swap(merged);
+}
+
+}
 
 MonteCarloSimulator::MonteCarloSimulator(QObject *parent)
     : QObject(parent)
     , m_stopRequested(false)
+    , m_samplingMode(IndependentSampling)
 {
     std::random_device rd;
     m_generator = std::mt19937(rd());
@@ -19,6 +85,24 @@ void MonteCarloSimulator::runSimulation(const QVector<double> &outcomes,
                                         int numSimulations,
                                         bool randomizeOrder,
                                         double confidenceLevel) {
+    runJob(outcomes, QVector<int>(), initialBalance, numSimulations, randomizeOrder, confidenceLevel);
+}
+
+void MonteCarloSimulator::runBlockSimulation(const QVector<double> &outcomes,
+                                             const QVector<int> &blockStarts,
+                                             double initialBalance,
+                                             int numSimulations,
+                                             bool randomizeOrder,
+                                             double confidenceLevel) {
+    runJob(outcomes, blockStarts, initialBalance, numSimulations, randomizeOrder, confidenceLevel);
+}
+
+void MonteCarloSimulator::runJob(const QVector<double> &outcomes,
+                                 const QVector<int> &blockStarts,
+                                 double initialBalance,
+                                 int numSimulations,
+                                 bool randomizeOrder,
+                                 double confidenceLevel) {
     if (outcomes.isEmpty()) {
         emit simulationFailed("No trade data available");
         return;
@@ -31,46 +115,428 @@ void MonteCarloSimulator::runSimulation(const QVector<double> &outcomes,
 
     m_stopRequested = false;
 
-    QVector<SimulationResult> results;
-    results.reserve(numSimulations);
+    // one seed per job, every run derives its own shuffle from it
+    const quint64 seed = (static_cast<quint64>(m_generator()) << 32) | m_generator();
 
     try {
-        for (int i = 0; i < numSimulations; ++i) {
-            if (m_stopRequested) {
-                emit simulationStopped();
-                return;
+        PartialAggregate stressedPartial;
+        PartialAggregate partial = runShard(outcomes, blockStarts, initialBalance, seed, 0, numSimulations,
+                                            randomizeOrder, m_samplingMode, m_stressScenario, &stressedPartial);
+
+        if (m_stopRequested) {
+            emit simulationStopped();
+            return;
+        }
+
+        AggregatedMetrics metrics = finalizeAggregate(partial, confidenceLevel);
+        QVariantMap metricsMap = metricsToVariantMap(metrics);
+        if (stressedPartial.stressed) {
+            metricsMap["stressed"] = metricsToVariantMap(finalizeAggregate(stressedPartial, confidenceLevel));
+        }
+        emit simulationComplete(metricsMap);
+
+    } catch (const std::exception &e) {
+        emit simulationFailed(QString("Simulation error: %1").arg(e.what()));
+    }
+}
+
+MonteCarloSimulator::PartialAggregate
+MonteCarloSimulator::runShard(const QVector<double> &outcomes,
+                              const QVector<int> &blockStarts,
+                              double initialBalance,
+                              quint64 seed,
+                              int firstRun,
+                              int runCount,
+                              bool randomizeOrder,
+                              SamplingMode samplingMode,
+                              const StressScenario &stress,
+                              PartialAggregate *stressedPartial) {
+    for (int b = 0; b < blockStarts.size(); ++b) {
+        int end = (b + 1 < blockStarts.size()) ? blockStarts[b + 1] : outcomes.size();
+        if ((b == 0 && blockStarts[b] != 0) || blockStarts[b] >= end) {
+            throw std::invalid_argument("Invalid block boundaries");
+        }
+    }
+
+    // units are single trades, or whole blocks when blockStarts is given
+    const int unitCount = blockStarts.isEmpty() ? outcomes.size() : blockStarts.size();
+    auto unitBegin = [&](int unit) { return blockStarts.isEmpty() ? unit : blockStarts[unit]; };
+    auto unitEnd = [&](int unit) {
+        if (blockStarts.isEmpty()) return unit + 1;
+        return unit + 1 < blockStarts.size() ? blockStarts[unit + 1] : static_cast<int>(outcomes.size());
+    };
+
+    // units ranked from the largest loss to the largest win
+    QVector<int> byResult;
+    QVector<int> heavyUnits;
+    if (randomizeOrder && samplingMode != IndependentSampling) {
+        QVector<double> unitTotals(unitCount, 0.0);
+        for (int unit = 0; unit < unitCount; ++unit) {
+            unitTotals[unit] = std::accumulate(outcomes.cbegin() + unitBegin(unit), outcomes.cbegin() + unitEnd(unit), 0.0);
+        }
+
+        byResult.resize(unitCount);
+        std::iota(byResult.begin(), byResult.end(), 0);
+        std::stable_sort(byResult.begin(), byResult.end(), [&unitTotals](int a, int b) {
+            return unitTotals[a] < unitTotals[b];
+        });
+
+        const int heavyLimit = samplingMode == StratifiedSampling ? std::min(kStratifiedLosses, unitCount) : 0;
+        for (int rank = 0; rank < heavyLimit && unitTotals[byResult[rank]] < 0; ++rank) {
+            heavyUnits.append(byResult[rank]);
+        }
+    }
+
+    // stratified runs place the largest losing units first, the rest is shuffled around them
+    QVector<int> lightUnits;
+    if (!heavyUnits.isEmpty()) {
+        lightUnits = byResult.mid(heavyUnits.size());
+    }
+
+    if (!randomizeOrder || heavyUnits.isEmpty()) {
+        samplingMode = IndependentSampling;
+    }
+
+    PartialAggregate partial;
+    partial.seed = seed;
+    partial.firstRun = firstRun;
+    partial.totalTrades = outcomes.size();
+    partial.initialBalance = initialBalance;
+    partial.randomizeOrder = randomizeOrder;
+    partial.samplingMode = samplingMode;
+
+    const int step = plotStep(outcomes.size());
+    partial.stepBalances.resize(outcomes.size() / step + 1);
+    for (auto &column : partial.stepBalances) {
+        column.reserve(runCount);
+    }
+
+    for (auto *column : metricColumns(partial)) {
+        column->reserve(runCount);
+    }
+    partial.runMaxDrawdowns.reserve(runCount);
+
+    QVector<double> simOutcomes(outcomes.size());
+    QVector<int> unitOrder(unitCount);
+    QVector<int> shuffledLight(lightUnits.size());
+    QVector<std::array<int, kStrata>> cycleStrata(heavyUnits.size());
+    int strataCycle = -1;
+
+    // stress replays each run's path perturbed, on the same order as the baseline
+    const bool stressed = stressedPartial && stress.isActive();
+    QVector<double> stressedOutcomes;
+    QVector<double> streakMask;
+    QVector<double> keepStream;     // 1 keeps a trade, 0 skips it
+    QVector<int> streakStream;      // start of every injected streak
+    // more streaks than trades cannot change a run, and bounds the streak buffer
+    const int streaksPerRun = stress.lossStreakLength > 0
+        ? std::min(stress.lossStreaks, static_cast<int>(outcomes.size()))
+        : 0;
+    const int streakLength = std::min(stress.lossStreakLength, static_cast<int>(outcomes.size()));
+    int stressBatch = -1;
+    double streakLoss = 0;
+
+    if (stressed) {
+        *stressedPartial = partial;
+        stressedPartial->stressed = true;
+        stressedOutcomes.resize(outcomes.size());
+        streakMask.resize(outcomes.size() + 1);
+        keepStream.resize(static_cast<qsizetype>(kStressBatch) * outcomes.size());
+        streakStream.resize(static_cast<qsizetype>(kStressBatch) * streaksPerRun);
+
+        // injected streak trades lose the average (stressed) loss of the report,
+        // or the average trade size when the report has no losing trade
+        double lossSum = 0;
+        double sizeSum = 0;
+        int lossCount = 0;
+        for (double outcome : outcomes) {
+            sizeSum += std::abs(outcome);
+            if (outcome < 0) {
+                lossSum += outcome;
+                lossCount++;
+            }
+        }
+        const double averageLoss = lossCount > 0 ? lossSum / lossCount : -sizeSum / outcomes.size();
+        streakLoss = averageLoss * (1.0 + stress.loserInflation) - stress.costPerTrade;
+    }
+
+    for (int i = 0; i < runCount; ++i) {
+        if (m_stopRequested) {
+            break;
+        }
+
+        const int run = firstRun + i;
+
+        // every run starts from the original order so it does not depend on the runs before it
+        std::iota(unitOrder.begin(), unitOrder.end(), 0);
+
+        if (samplingMode == StratifiedSampling) {
+            // each heavy loss takes a uniformly drawn free slot, with the draw
+            // stratified across runs; the resulting permutation is still uniform
+            std::mt19937 generator = runGenerator(seed, run);
+            std::uniform_real_distribution<double> jitter(0.0, 1.0);
+            unitOrder.fill(-1);
+
+            if (run / kStrata != strataCycle) {
+                strataCycle = run / kStrata;
+                for (int loss = 0; loss < heavyUnits.size(); ++loss) {
+                    cycleStrata[loss] = latinCycle(seed, strataCycle, loss);
+                }
             }
 
-            QVector<double> simOutcomes = outcomes;
+            for (int loss = 0; loss < heavyUnits.size(); ++loss) {
+                const double u = (cycleStrata[loss][run % kStrata] + jitter(generator)) / kStrata;
+                const int freeSlots = unitCount - loss;
+                int target = std::min(static_cast<int>(u * freeSlots), freeSlots - 1);
 
-            if (randomizeOrder) {
-                std::shuffle(simOutcomes.begin(), simOutcomes.end(), m_generator);
+                int slot = 0;
+                for (;; ++slot) {
+                    if (unitOrder[slot] < 0 && target-- == 0) break;
+                }
+                unitOrder[slot] = heavyUnits[loss];
             }
 
-            SimulationResult result = runSingleSimulation(simOutcomes, initialBalance);
-            results.append(result);
+            std::copy(lightUnits.cbegin(), lightUnits.cend(), shuffledLight.begin());
+            std::shuffle(shuffledLight.begin(), shuffledLight.end(), generator);
 
-            if (i % 10 == 0 || i == numSimulations - 1) {
-                emit simulationProgress(i + 1, numSimulations);
+            auto next = shuffledLight.cbegin();
+            for (int &unit : unitOrder) {
+                if (unit < 0) unit = *next++;
             }
+        } else if (randomizeOrder) {
+            std::mt19937 generator = runGenerator(seed, run);
+            std::shuffle(unitOrder.begin(), unitOrder.end(), generator);
         }
 
-        AggregatedMetrics metrics = aggregateResults(results, outcomes.size(), initialBalance, confidenceLevel);
-        QVariantMap metricsMap = metricsToVariantMap(metrics);
-        emit simulationComplete(metricsMap);
+        auto out = simOutcomes.begin();
+        for (int unit : unitOrder) {
+            out = std::copy(outcomes.cbegin() + unitBegin(unit), outcomes.cbegin() + unitEnd(unit), out);
+        }
 
-    } catch (const std::exception &e) {
-        emit simulationFailed(QString("Simulation error: %1").arg(e.what()));
+        SimulationResult result = runSingleSimulation(simOutcomes, initialBalance);
+        accumulateResult(partial, result, run, step);
+        partial.runCount++;
+
+        if (stressed) {
+            // one stream per batch of runs, keyed by the batch index so shards draw the same numbers
+            const int batch = run / kStressBatch;
+            if (batch != stressBatch) {
+                std::mt19937 generator = runGenerator(seed, batch, kStressStream);
+                if (stress.skipFraction > 0) {
+                    const quint64 skipBelow = static_cast<quint64>(stress.skipFraction * 4294967296.0);
+                    for (double &keep : keepStream) {
+                        keep = generator() >= skipBelow ? 1.0 : 0.0;
+                    }
+                } else {
+                    keepStream.fill(1.0);
+                }
+                for (int &start : streakStream) {
+                    start = static_cast<int>((static_cast<quint64>(generator()) * (outcomes.size() - streakLength + 1)) >> 32);
+                }
+                stressBatch = batch;
+            }
+
+            const qsizetype slot = run % kStressBatch;
+            const double *keep = keepStream.constData() + slot * outcomes.size();
+            std::copy(simOutcomes.cbegin(), simOutcomes.cend(), stressedOutcomes.begin());
+            applyStress(stress, streakLoss, keep,
+                        streakStream.constData() + slot * streaksPerRun, streaksPerRun, streakLength,
+                        stressedOutcomes, streakMask);
+
+            accumulateResult(*stressedPartial, runSingleSimulation(stressedOutcomes, initialBalance, keep), run, step);
+            stressedPartial->runCount++;
+        }
+
+        if (i % 10 == 0 || i == runCount - 1) {
+            emit simulationProgress(i + 1, runCount);
+        }
+    }
+
+    sortColumns(partial);
+    if (stressed) {
+        sortColumns(*stressedPartial);
+    }
+
+    return partial;
+}
+
+void MonteCarloSimulator::applyStress(const StressScenario &stress, double streakLoss,
+                                      const double *keep, const int *streakStarts, int streakCount, int streakLength,
+                                      QVector<double> &path, QVector<double> &streakMask)
+{
+    const int size = path.size();
+
+    // streak coverage as a running sum of +1 at each start and -1 past its end
+    std::fill(streakMask.begin(), streakMask.end(), 0.0);
+    if (streakCount > 0) {
+        for (int s = 0; s < streakCount; ++s) {
+            streakMask[streakStarts[s]] += 1.0;
+            streakMask[streakStarts[s] + streakLength] -= 1.0;
+        }
+        double depth = 0;
+        for (int i = 0; i < size; ++i) {
+            depth += streakMask[i];
+            streakMask[i] = std::min(depth, 1.0);
+        }
+    }
+
+    // branch-free so the loop vectorizes: wins and losses split by max/min,
+    // streaks and skips applied as 0/1 factors
+    const double winFactor = 1.0 - stress.winnerHaircut;
+    const double lossFactor = 1.0 + stress.loserInflation;
+    const double cost = stress.costPerTrade;
+    double *out = path.data();
+    const double *streak = streakMask.constData();
+
+    for (int i = 0; i < size; ++i) {
+        const double outcome = out[i];
+        double stressed = std::max(outcome, 0.0) * winFactor + std::min(outcome, 0.0) * lossFactor - cost;
+        stressed += streak[i] * (streakLoss - stressed);
+        // skipped trades stay in the path as flat so every run keeps its length
+        out[i] = stressed * keep[i];
     }
 }
 
+void MonteCarloSimulator::accumulateResult(PartialAggregate &partial, const SimulationResult &result, int run, int step)
+{
+    partial.returns.append(result.returnPercent);
+    partial.maxDrawdowns.append(result.maxDrawdownPercent);
+    partial.sharpeRatios.append(result.sharpeRatio);
+    partial.profitFactors.append(result.profitFactor);
+    partial.calmarRatios.append(result.calmarRatio);
+    partial.winRates.append(result.winRate);
+    partial.riskRewards.append(result.riskRewardRatio);
+    partial.avgLosses.append(result.avgLoss);
+    partial.finalBalances.append(result.finalBalance);
+    partial.runMaxDrawdowns.append(result.maxDrawdownPercent);
+
+    if (result.avgWin > partial.largestWin) partial.largestWin = result.avgWin;
+
+    const auto &rawCurve = result.equityCurve;
+    for (int k = 0; k < partial.stepBalances.size(); ++k) {
+        int t = k * step;
+        partial.stepBalances[k].append(t < rawCurve.size() ? rawCurve[t] : result.finalBalance);
+    }
+
+    // runs arrive in ascending order, so the first ones seen are the lowest indices
+    if (partial.sampleRuns.size() < kSampleCurveCount) {
+        QVector<QPointF> curve;
+        for (int t = 0; t < rawCurve.size(); t += step) {
+            curve.append(QPointF(t, rawCurve[t]));
+        }
+        partial.sampleRuns.append(run);
+        partial.sampleCurves.append(curve);
+    }
+}
+
+MonteCarloSimulator::PartialAggregate
+MonteCarloSimulator::mergePartials(QVector<PartialAggregate> partials)
+{
+    if (partials.isEmpty()) {
+        throw std::runtime_error("No partial results to merge");
+    }
+
+    std::sort(partials.begin(), partials.end(), [](const PartialAggregate &a, const PartialAggregate &b) {
+        return a.firstRun < b.firstRun;
+    });
+
+    PartialAggregate merged = partials.first();
+
+    for (int i = 1; i < partials.size(); ++i) {
+        const PartialAggregate &next = partials[i];
+
+        if (next.seed != merged.seed
+            || next.totalTrades != merged.totalTrades
+            || next.initialBalance != merged.initialBalance
+            || next.randomizeOrder != merged.randomizeOrder
+            || next.samplingMode != merged.samplingMode
+            || next.stressed != merged.stressed
+            || next.stepBalances.size() != merged.stepBalances.size()) {
+            throw std::runtime_error("Partial results belong to different simulations");
+        }
+
+        if (next.firstRun != merged.firstRun + merged.runCount) {
+            throw std::runtime_error("Partial results do not cover a contiguous run range");
+        }
+
+        mergeSorted(merged.returns, next.returns);
+        mergeSorted(merged.maxDrawdowns, next.maxDrawdowns);
+        mergeSorted(merged.sharpeRatios, next.sharpeRatios);
+        mergeSorted(merged.profitFactors, next.profitFactors);
+        mergeSorted(merged.calmarRatios, next.calmarRatios);
+        mergeSorted(merged.winRates, next.winRates);
+        mergeSorted(merged.riskRewards, next.riskRewards);
+        mergeSorted(merged.avgLosses, next.avgLosses);
+        mergeSorted(merged.finalBalances, next.finalBalances);
+
+        merged.runMaxDrawdowns.append(next.runMaxDrawdowns);
+
+        for (int k = 0; k < merged.stepBalances.size(); ++k) {
+            mergeSorted(merged.stepBalances[k], next.stepBalances[k]);
+        }
+
+        if (next.largestWin > merged.largestWin) merged.largestWin = next.largestWin;
+
+        for (int s = 0; s < next.sampleRuns.size() && merged.sampleRuns.size() < kSampleCurveCount; ++s) {
+            merged.sampleRuns.append(next.sampleRuns[s]);
+            merged.sampleCurves.append(next.sampleCurves[s]);
+        }
+
+        merged.runCount += next.runCount;
+    }
+
+    return merged;
+}
+
 void MonteCarloSimulator::stopSimulation()
 {
     m_stopRequested = true;
 }
 
+void MonteCarloSimulator::setStressScenario(double winnerHaircut, double loserInflation, double skipFraction,
+                                            double costPerTrade, int lossStreaks, int lossStreakLength)
+{
+    m_stressScenario = StressScenario::bounded(winnerHaircut, loserInflation, skipFraction,
+                                               costPerTrade, lossStreaks, lossStreakLength);
+}
+
+MonteCarloSimulator::StressScenario
+MonteCarloSimulator::StressScenario::bounded(double winnerHaircut, double loserInflation, double skipFraction,
+                                             double costPerTrade, int lossStreaks, int lossStreakLength)
+{
+    StressScenario stress;
+    stress.winnerHaircut = std::clamp(winnerHaircut, 0.0, 1.0);
+    stress.loserInflation = std::max(loserInflation, 0.0);
+    stress.skipFraction = std::clamp(skipFraction, 0.0, 1.0);
+    stress.costPerTrade = std::max(costPerTrade, 0.0);
+    stress.lossStreaks = std::max(lossStreaks, 0);
+    stress.lossStreakLength = std::max(lossStreakLength, 0);
+    return stress;
+}
+
+MonteCarloSimulator::StressScenario::StressScenario()
+    : winnerHaircut(0)
+    , loserInflation(0)
+    , skipFraction(0)
+    , costPerTrade(0)
+    , lossStreaks(0)
+    , lossStreakLength(0)
+{
+}
+
+bool MonteCarloSimulator::StressScenario::isActive() const
+{
+    return winnerHaircut > 0 || loserInflation > 0 || skipFraction > 0 || costPerTrade > 0
+        || (lossStreaks > 0 && lossStreakLength > 0);
+}
+
+void MonteCarloSimulator::setSamplingMode(int mode)
+{
+    m_samplingMode = mode == StratifiedSampling ? StratifiedSampling : IndependentSampling;
+}
+
 MonteCarloSimulator::SimulationResult
-MonteCarloSimulator::runSingleSimulation(const QVector<double> &outcomes, double initialBalance) {
+MonteCarloSimulator::runSingleSimulation(const QVector<double> &outcomes, double initialBalance, const double *keep) {
     SimulationResult result;
     result.equityCurve.reserve(outcomes.size() + 1);
 
@@ -85,6 +551,7 @@ MonteCarloSimulator::runSingleSimulation(const QVector<double> &outcomes, double
     double grossProfit = 0;
     double grossLoss = 0;
     int winningTrades = 0;
+    int executedTrades = 0;
 
     QVector<double> wins;
     QVector<double> losses;
@@ -92,7 +559,8 @@ MonteCarloSimulator::runSingleSimulation(const QVector<double> &outcomes, double
 
     result.equityCurve.append(balance); // trade 0
 
-    for (double outcome : outcomes) {
+    for (int i = 0; i < outcomes.size(); ++i) {
+        const double outcome = outcomes[i];
         balance += outcome;
         result.equityCurve.append(balance);
 
@@ -106,6 +574,12 @@ MonteCarloSimulator::runSingleSimulation(const QVector<double> &outcomes, double
             maxDrawdownPercent = (maxDrawdown / peak) * 100.0;
         }
 
+        // skipped trades keep the curve flat but are no trade for the per-trade stats
+        if (keep && keep[i] == 0.0) {
+            continue;
+        }
+        executedTrades++;
+
         if (outcome > 0) {
             winningTrades++;
             grossProfit += outcome;
@@ -127,7 +601,7 @@ MonteCarloSimulator::runSingleSimulation(const QVector<double> &outcomes, double
     result.maxDrawdown = maxDrawdown;
     result.maxDrawdownPercent = maxDrawdownPercent;
     result.maxConsecutiveLosses = maxConsecutiveLosses;
-    result.winRate = (static_cast<double>(winningTrades) / outcomes.size()) * 100.0;
+    result.winRate = executedTrades > 0 ? (static_cast<double>(winningTrades) / executedTrades) * 100.0 : 0;
     result.avgWin = wins.isEmpty() ? 0 : std::accumulate(wins.begin(), wins.end(), 0.0) / wins.size();
     result.avgLoss = losses.isEmpty() ? 0 : std::accumulate(losses.begin(), losses.end(), 0.0) / losses.size();
     result.riskRewardRatio = (result.avgLoss != 0) ? result.avgWin / result.avgLoss : 0;
@@ -150,67 +624,27 @@ MonteCarloSimulator::runSingleSimulation(const QVector<double> &outcomes, double
 }
 
 MonteCarloSimulator::AggregatedMetrics
-MonteCarloSimulator::aggregateResults(const QVector<SimulationResult> &results, int totalTrades, double initialBalance, double confidenceLevel) {
-    AggregatedMetrics metrics;
-    metrics.numSimulations = results.size();
-    metrics.totalTrades = totalTrades;
-
-    QVector<double> returns;
-    QVector<double> maxDrawdowns;
-    QVector<double> sharpeRatios;
-    QVector<double> profitFactors;
-    QVector<double> calmarRatios;
-    QVector<double> winRates;
-    QVector<double> riskRewards;
-    QVector<double> avgLosses;
-    QVector<double> finalBalances;
-
-    double totalWins = 0;
-    double largestWin = 0;
-
-    double globalMinY = initialBalance;
-    double globalMaxY = initialBalance;
-
-
-    for (const auto &result : results) {
-        returns.append(result.returnPercent);
-        maxDrawdowns.append(result.maxDrawdownPercent);
-        sharpeRatios.append(result.sharpeRatio);
-        profitFactors.append(result.profitFactor);
-        calmarRatios.append(result.calmarRatio);
-        winRates.append(result.winRate);
-        riskRewards.append(result.riskRewardRatio);
-        avgLosses.append(result.avgLoss);
-        finalBalances.append(result.finalBalance);
-
-        if (result.avgWin > largestWin) largestWin = result.avgWin;
+MonteCarloSimulator::finalizeAggregate(const PartialAggregate &partial, double confidenceLevel) {
+    if (partial.runCount <= 0) {
+        throw std::runtime_error("No simulation runs to aggregate");
     }
 
-    int pointsToPlot = totalTrades + 1;
-    int step = (pointsToPlot > 500) ? pointsToPlot / 500 : 1;
+    AggregatedMetrics metrics;
+    metrics.numSimulations = partial.runCount;
+    metrics.totalTrades = partial.totalTrades;
 
-    for (int t = 0; t < pointsToPlot; t += step) {
-        QVector<double> balancesAtStep;
-        balancesAtStep.reserve(results.size());
+    double globalMinY = partial.initialBalance;
+    double globalMaxY = partial.initialBalance;
 
-        for (const auto& res : results) {
-            if (t < res.equityCurve.size()) {
-                balancesAtStep.append(res.equityCurve[t]);
-            } else {
-                balancesAtStep.append(res.finalBalance);
-            }
-        }
+    const int step = plotStep(partial.totalTrades);
 
-        std::sort(balancesAtStep.begin(), balancesAtStep.end());
+    for (int k = 0; k < partial.stepBalances.size(); ++k) {
+        const auto &balancesAtStep = partial.stepBalances[k];
+        int t = k * step;
 
         // median-50th
-        double medianVal = balancesAtStep[balancesAtStep.size() / 2];
-
-        double percentile = 100.0 - confidenceLevel;
-        int confIndex = static_cast<int>((percentile / 100.0) * balancesAtStep.size());
-        if (confIndex < 0) confIndex = 0;
-        if (confIndex >= balancesAtStep.size()) confIndex = balancesAtStep.size() - 1;
-        double confVal = balancesAtStep[confIndex];
+        double medianVal = percentileOfSorted(balancesAtStep, 50);
+        double confVal = percentileOfSorted(balancesAtStep, 100.0 - confidenceLevel);
 
         metrics.medianCurve.append(QPointF(t, medianVal));
         metrics.confidenceCurve.append(QPointF(t, confVal));
@@ -220,59 +654,111 @@ MonteCarloSimulator::aggregateResults(const QVector<SimulationResult> &results,
         if (medianVal > globalMaxY) globalMaxY = medianVal;
     }
 
-    int sampleCount = std::min(5, (int)results.size());
-    for(int i=0; i<sampleCount; ++i) {
-        QVector<QPointF> curve;
-        const auto& rawCurve = results[i].equityCurve;
-
-        for(int t=0; t<rawCurve.size(); t += step) {
-            curve.append(QPointF(t, rawCurve[t]));
-            if (rawCurve[t] > globalMaxY) globalMaxY = rawCurve[t];
-            if (rawCurve[t] < globalMinY) globalMinY = rawCurve[t];
+    for (const auto &curve : partial.sampleCurves) {
+        for (const auto &p : curve) {
+            if (p.y() > globalMaxY) globalMaxY = p.y();
+            if (p.y() < globalMinY) globalMinY = p.y();
         }
         metrics.sampleCurves.append(curve);
     }
 
-    metrics.maxX = totalTrades;
+    const auto &returns = partial.returns;
+    const auto &maxDrawdowns = partial.maxDrawdowns;
+
+    metrics.maxX = partial.totalTrades;
     metrics.minY = globalMinY;
     metrics.maxY = globalMaxY;
-    metrics.medianReturn = calculatePercentile(returns, 50);
+    metrics.medianReturn = percentileOfSorted(returns, 50);
     metrics.meanReturn = std::accumulate(returns.begin(), returns.end(), 0.0) / returns.size();
-    metrics.bestReturn = calculatePercentile(returns, 99);
-    metrics.worstReturn = calculatePercentile(returns, 1);
-    metrics.medianMaxDrawdown = calculatePercentile(maxDrawdowns, 50);
-    metrics.bestMaxDrawdown = calculatePercentile(maxDrawdowns, 5);
-    metrics.worstMaxDrawdown = calculatePercentile(maxDrawdowns, 95);
-    metrics.medianSharpeRatio = calculatePercentile(sharpeRatios, 50);
-    metrics.medianProfitFactor = calculatePercentile(profitFactors, 50);
-    metrics.medianCalmarRatio = calculatePercentile(calmarRatios, 50);
-    metrics.medianWinRate = calculatePercentile(winRates, 50);
-    metrics.valueAtRisk95 = calculatePercentile(returns, 5);
-
-    int ruinCount = 0;
-    for (const auto &result : results) {
-        if (result.maxDrawdownPercent > 90) {
-            ruinCount++;
-        }
-    }
-    metrics.riskOfRuin = (static_cast<double>(ruinCount) / results.size()) * 100.0;
+    metrics.bestReturn = percentileOfSorted(returns, 99);
+    metrics.worstReturn = percentileOfSorted(returns, 1);
+    metrics.medianMaxDrawdown = percentileOfSorted(maxDrawdowns, 50);
+    metrics.bestMaxDrawdown = percentileOfSorted(maxDrawdowns, 5);
+    metrics.worstMaxDrawdown = percentileOfSorted(maxDrawdowns, 95);
+    metrics.medianSharpeRatio = percentileOfSorted(partial.sharpeRatios, 50);
+    metrics.medianProfitFactor = percentileOfSorted(partial.profitFactors, 50);
+    metrics.medianCalmarRatio = percentileOfSorted(partial.calmarRatios, 50);
+    metrics.medianWinRate = percentileOfSorted(partial.winRates, 50);
+    metrics.valueAtRisk95 = percentileOfSorted(returns, 5);
+
+    auto ruinBegin = std::upper_bound(maxDrawdowns.begin(), maxDrawdowns.end(), 90.0);
+    int ruinCount = static_cast<int>(maxDrawdowns.end() - ruinBegin);
+    metrics.riskOfRuin = (static_cast<double>(ruinCount) / partial.runCount) * 100.0;
+
+    const auto &riskRewards = partial.riskRewards;
+    const auto &avgLosses = partial.avgLosses;
+    const auto &finalBalances = partial.finalBalances;
     metrics.avgRiskReward = std::accumulate(riskRewards.begin(), riskRewards.end(), 0.0) / riskRewards.size();
     metrics.avgLoss = std::accumulate(avgLosses.begin(), avgLosses.end(), 0.0) / avgLosses.size();
-    metrics.largestWin = largestWin;
+    metrics.largestWin = partial.largestWin;
     double avgFinalBalance = std::accumulate(finalBalances.begin(), finalBalances.end(), 0.0) / finalBalances.size();
-    metrics.expectancyPerTrade = avgFinalBalance / totalTrades;
+    metrics.expectancyPerTrade = avgFinalBalance / partial.totalTrades;
+
+    // how many independent runs the drawdown tail estimate is worth. the return
+    // tail needs no such figure: the final balance does not depend on trade order
+    QVector<bool> worstDrawdownHits(partial.runMaxDrawdowns.size());
+    for (int i = 0; i < worstDrawdownHits.size(); ++i) {
+        worstDrawdownHits[i] = partial.runMaxDrawdowns[i] >= metrics.worstMaxDrawdown;
+    }
+    metrics.samplingMode = partial.samplingMode;
+    metrics.effectiveSampleSize = effectiveSampleSize(partial, worstDrawdownHits);
 
     return metrics;
 }
 
-double MonteCarloSimulator::calculatePercentile(QVector<double> values, double percentile)
+double MonteCarloSimulator::effectiveSampleSize(const PartialAggregate &partial, const QVector<bool> &hits)
 {
-    if (values.isEmpty()) return 0;
-    std::sort(values.begin(), values.end());
-    int index = static_cast<int>((percentile / 100.0) * values.size());
-    if (index >= values.size()) index = values.size() - 1;
+    // hits[i] marks run firstRun + i landing in the tail. the result is the number of
+    // independent runs that would estimate the tail probability as precisely
+    const int n = hits.size();
+    if (n < 2) return n;
+
+    const double p = static_cast<double>(std::count(hits.begin(), hits.end(), true)) / n;
+    const double variance = p * (1.0 - p);
+    if (variance <= 0) return n;
+
+    double estimatorVariance = variance / n;
+
+    if (partial.samplingMode == StratifiedSampling) {
+        // post-stratified on the slot of the largest loss only, so it understates the gain
+        std::array<int, kStrata> counts{};
+        std::array<int, kStrata> stratumHits{};
+        std::array<int, kStrata> strata{};
+        for (int i = 0; i < n; ++i) {
+            const int run = partial.firstRun + i;
+            if (i == 0 || run % kStrata == 0) {
+                strata = latinCycle(partial.seed, run / kStrata, 0);
+            }
+            int stratum = strata[run % kStrata];
+            counts[stratum]++;
+            stratumHits[stratum] += hits[i];
+        }
+
+        double withinVariance = 0;
+        for (int h = 0; h < kStrata; ++h) {
+            if (counts[h] == 0) continue;
+            double ph = static_cast<double>(stratumHits[h]) / counts[h];
+            withinVariance += counts[h] * ph * (1.0 - ph);
+        }
+        estimatorVariance = withinVariance / n / n;
+    }
+
+    return estimatorVariance > 0 ? variance / estimatorVariance : n;
+}
+
+int MonteCarloSimulator::plotStep(int totalTrades)
+{
+    int pointsToPlot = totalTrades + 1;
+    return (pointsToPlot > 500) ? pointsToPlot / 500 : 1;
+}
+
+double MonteCarloSimulator::percentileOfSorted(const QVector<double> &sorted, double percentile)
+{
+    if (sorted.isEmpty()) return 0;
+    int index = static_cast<int>((percentile / 100.0) * sorted.size());
+    if (index >= sorted.size()) index = sorted.size() - 1;
     if (index < 0) index = 0;
-    return values[index];
+    return sorted[index];
 }
 
 QVariantMap MonteCarloSimulator::metricsToVariantMap(const AggregatedMetrics &metrics)
@@ -301,6 +787,8 @@ QVariantMap MonteCarloSimulator::metricsToVariantMap(const AggregatedMetrics &me
     map["minY"] = metrics.minY;
     map["maxY"] = metrics.maxY;
     map["maxX"] = metrics.maxX;
+    map["samplingMode"] = metrics.samplingMode;
+    map["effectiveSampleSize"] = metrics.effectiveSampleSize;
 
     auto pointToVar = [](const QPointF& p) {
         QVariantMap m;
@@ -318,7 +806,7 @@ QVariantMap MonteCarloSimulator::metricsToVariantMap(const AggregatedMetrics &me
     map["confidenceCurve"] = confCurveList;
 
     // sample curves
-    for (int i = 0; i < 5; ++i) {
+    for (int i = 0; i < kSampleCurveCount; ++i) {
         QVariantList singleCurveList;
         if (i < metrics.sampleCurves.size()) {
             for(const auto& p : metrics.sampleCurves[i]) {
@@ -331,3 +819,52 @@ QVariantMap MonteCarloSimulator::metricsToVariantMap(const AggregatedMetrics &me
 
     return map;
 }
+
+QDataStream &operator<<(QDataStream &out, const MonteCarloSimulator::PartialAggregate &partial)
+{
+    out << kPartialMagic << kPartialVersion;
+    out << partial.seed << partial.firstRun << partial.runCount << partial.totalTrades
+        << partial.initialBalance << partial.randomizeOrder << partial.samplingMode
+        << partial.stressed;
+    out << partial.returns << partial.maxDrawdowns << partial.sharpeRatios
+        << partial.profitFactors << partial.calmarRatios << partial.winRates
+        << partial.riskRewards << partial.avgLosses << partial.finalBalances;
+    out << partial.largestWin << partial.runMaxDrawdowns << partial.stepBalances;
+    out << partial.sampleRuns << partial.sampleCurves;
+    return out;
+}
+
+QDataStream &operator>>(QDataStream &in, MonteCarloSimulator::PartialAggregate &partial)
+{
+    quint32 magic = 0;
+    quint32 version = 0;
+    in >> magic >> version;
+    if (magic != kPartialMagic || version != kPartialVersion) {
+        in.setStatus(QDataStream::ReadCorruptData);
+        return in;
+    }
+
+    in >> partial.seed >> partial.firstRun >> partial.runCount >> partial.totalTrades
+       >> partial.initialBalance >> partial.randomizeOrder >> partial.samplingMode
+       >> partial.stressed;
+    in >> partial.returns >> partial.maxDrawdowns >> partial.sharpeRatios
+       >> partial.profitFactors >> partial.calmarRatios >> partial.winRates
+       >> partial.riskRewards >> partial.avgLosses >> partial.finalBalances;
+    in >> partial.largestWin >> partial.runMaxDrawdowns >> partial.stepBalances;
+    in >> partial.sampleRuns >> partial.sampleCurves;
+    return in;
+}
+
+QDataStream &operator<<(QDataStream &out, const MonteCarloSimulator::StressScenario &stress)
+{
+    out << stress.winnerHaircut << stress.loserInflation << stress.skipFraction
+        << stress.costPerTrade << stress.lossStreaks << stress.lossStreakLength;
+    return out;
+}
+
+QDataStream &operator>>(QDataStream &in, MonteCarloSimulator::StressScenario &stress)
+{
+    in >> stress.winnerHaircut >> stress.loserInflation >> stress.skipFraction
+       >> stress.costPerTrade >> stress.lossStreaks >> stress.lossStreakLength;
+    return in;
+}
@@ -5,6 +5,7 @@
 #include <QString>
 #include <QVector>
 #include <QPointF>
+#include <QDataStream>
 #include <random>
 
 class MonteCarloSimulator : public QObject
@@ -14,6 +15,34 @@ class MonteCarloSimulator : public QObject
 public:
     explicit MonteCarloSimulator(QObject *parent = nullptr);
 
+    // how the run permutations are drawn. stratified places the largest losses in
+    // latin hypercube strata of the path across runs instead of independently; each
+    // permutation is still uniform, so every metric stays unbiased
+    enum SamplingMode {
+        IndependentSampling = 0,
+        StratifiedSampling = 1
+    };
+    Q_ENUM(SamplingMode)
+
+    // perturbation of every run's path before the path kernel, so the trade set
+    // changes and not only its order. a default scenario applies no stress
+    struct StressScenario {
+        StressScenario();
+
+        double winnerHaircut;    // fraction taken off every winning trade
+        double loserInflation;   // fraction added to every losing trade
+        double skipFraction;     // share of trades left out of each run
+        double costPerTrade;     // extra slippage and commission charged per trade
+        int lossStreaks;         // losing streaks injected into each run
+        int lossStreakLength;    // trades per injected streak
+
+        bool isActive() const;
+
+        // scenario with every field clamped to its valid range
+        static StressScenario bounded(double winnerHaircut, double loserInflation, double skipFraction,
+                                      double costPerTrade, int lossStreaks, int lossStreakLength);
+    };
+
     struct SimulationResult {
         double finalBalance;
         double returnPercent;
@@ -67,11 +96,71 @@ public:
         double minY;
         double maxY;
         int maxX;
+
+        // sampling
+        int samplingMode;
+        double effectiveSampleSize;     // independent runs the 95th percentile drawdown is worth
     };
 
+    // mergeable result of the runs [firstRun, firstRun + runCount) of a seeded job.
+    // every run draws its shuffle from (seed, run index) only, so shards covering
+    // disjoint ranges merge into exactly what a single process would produce
+    struct PartialAggregate {
+        quint64 seed = 0;
+        int firstRun = 0;
+        int runCount = 0;
+        int totalTrades = 0;
+        double initialBalance = 0;
+        bool randomizeOrder = true;
+        int samplingMode = IndependentSampling;
+        bool stressed = false;
+
+        // per-run metrics, each column kept sorted
+        QVector<double> returns;
+        QVector<double> maxDrawdowns;
+        QVector<double> sharpeRatios;
+        QVector<double> profitFactors;
+        QVector<double> calmarRatios;
+        QVector<double> winRates;
+        QVector<double> riskRewards;
+        QVector<double> avgLosses;
+        QVector<double> finalBalances;
+
+        double largestWin = 0;
+
+        // unsorted, in run order, for the effective sample size
+        QVector<double> runMaxDrawdowns;
+
+        // sorted balances of every run at each plotted trade index
+        QVector<QVector<double>> stepBalances;
+
+        // plotted curves of the lowest run indices in this range
+        QVector<int> sampleRuns;
+        QVector<QVector<QPointF>> sampleCurves;
+    };
+
+    // blockStarts, when given, splits outcomes into blocks (e.g. trading days) that are
+    // shuffled as a whole instead of trade by trade. with an active stress scenario and
+    // stressedPartial given, every run's path is also replayed perturbed into it
+    PartialAggregate runShard(const QVector<double> &outcomes, const QVector<int> &blockStarts,
+                              double initialBalance, quint64 seed,
+                              int firstRun, int runCount, bool randomizeOrder,
+                              SamplingMode samplingMode = IndependentSampling,
+                              const StressScenario &stress = StressScenario(),
+                              PartialAggregate *stressedPartial = nullptr);
+    static PartialAggregate mergePartials(QVector<PartialAggregate> partials);
+    static AggregatedMetrics finalizeAggregate(const PartialAggregate &partial, double confidenceLevel);
+    static QVariantMap metricsToVariantMap(const AggregatedMetrics &metrics);
+
+    bool stopRequested() const { return m_stopRequested; }
+
 public slots:
     void runSimulation(const QVector<double> &outcomes, double initialBalance, int numSimulations, bool randomizeOrder, double confidenceLevel);
+    void runBlockSimulation(const QVector<double> &outcomes, const QVector<int> &blockStarts, double initialBalance, int numSimulations, bool randomizeOrder, double confidenceLevel);
     void stopSimulation();
+    void setSamplingMode(int mode);
+    void setStressScenario(double winnerHaircut, double loserInflation, double skipFraction,
+                           double costPerTrade, int lossStreaks, int lossStreakLength);
 
 signals:
     void simulationProgress(int current, int total);
@@ -80,12 +169,25 @@ signals:
     void simulationStopped();
 
 private:
-    SimulationResult runSingleSimulation(const QVector<double> &outcomes, double initialBalance);
-    AggregatedMetrics aggregateResults(const QVector<SimulationResult> &results, int totalTrades, double initialBalance, double confidenceLevel);
-    QVariantMap metricsToVariantMap(const AggregatedMetrics &metrics);
-    double calculatePercentile(QVector<double> values, double percentile);
+    void runJob(const QVector<double> &outcomes, const QVector<int> &blockStarts, double initialBalance, int numSimulations, bool randomizeOrder, double confidenceLevel);
+    SimulationResult runSingleSimulation(const QVector<double> &outcomes, double initialBalance,
+                                         const double *keep = nullptr);
+    static void accumulateResult(PartialAggregate &partial, const SimulationResult &result, int run, int step);
+    static int plotStep(int totalTrades);
+    static double percentileOfSorted(const QVector<double> &sorted, double percentile);
+    static double effectiveSampleSize(const PartialAggregate &partial, const QVector<bool> &hits);
+    static void applyStress(const StressScenario &stress, double streakLoss,
+                            const double *keep, const int *streakStarts, int streakCount, int streakLength,
+                            QVector<double> &path, QVector<double> &streakMask);
     bool m_stopRequested;
+    SamplingMode m_samplingMode;
+    StressScenario m_stressScenario;
     std::mt19937 m_generator;
 };
 
+QDataStream &operator<<(QDataStream &out, const MonteCarloSimulator::PartialAggregate &partial);
+QDataStream &operator>>(QDataStream &in, MonteCarloSimulator::PartialAggregate &partial);
+QDataStream &operator<<(QDataStream &out, const MonteCarloSimulator::StressScenario &stress);
+QDataStream &operator>>(QDataStream &in, MonteCarloSimulator::StressScenario &stress);
+
 #endif
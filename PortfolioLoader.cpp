@@ -0,0 +1,175 @@
+#include "PortfolioLoader.h"
+#include <QFileInfo>
+#include <QtConcurrent>
+#include <algorithm>
+#include <functional>
+#include <numeric>
+#include <queue>
+#include <utility>
+#include <vector>
+
+namespace {
+
+constexpr qint64 kMsPerDay = 24LL * 60 * 60 * 1000;
+
+struct ReportJob {
+    int index;
+    QString filePath;
+};
+
+qint64 dayOf(qint64 timeMs)
+{
+    return timeMs >= 0 ? timeMs / kMsPerDay : (timeMs - kMsPerDay + 1) / kMsPerDay;
+}
+
+}
+
+PortfolioLoader::PortfolioLoader(QObject *parent)
+    : QObject(parent)
+    , m_watcher(nullptr)
+{
+}
+
+void PortfolioLoader::loadReports(const QStringList &filePaths, const QVector<double> &weights)
+{
+    if (m_watcher) {
+        emit loadingFailed("Reports are already being loaded");
+        return;
+    }
+
+    if (filePaths.isEmpty()) {
+        emit loadingFailed("No reports selected");
+        return;
+    }
+
+    m_filePaths = filePaths;
+    m_weights = weights;
+
+    // largest reports first, so the longest parse starts right away and the
+    // basket takes about as long as its biggest report
+    QVector<ReportJob> jobs;
+    QVector<qint64> sizes;
+    for (int i = 0; i < filePaths.size(); ++i) {
+        jobs.append({i, filePaths[i]});
+        sizes.append(QFileInfo(ExcelParser::localFilePath(filePaths[i])).size());
+    }
+    std::stable_sort(jobs.begin(), jobs.end(), [&sizes](const ReportJob &a, const ReportJob &b) {
+        return sizes[a.index] > sizes[b.index];
+    });
+
+    m_watcher = new QFutureWatcher<LoadResult>(this);
+    connect(m_watcher, &QFutureWatcher<LoadResult>::progressValueChanged, this, [this](int value) {
+        emit loadingProgress(value, m_filePaths.size());
+    });
+    connect(m_watcher, &QFutureWatcher<LoadResult>::finished, this, &PortfolioLoader::onReportsLoaded);
+
+    m_watcher->setFuture(QtConcurrent::mapped(std::move(jobs), [](const ReportJob &job) {
+        LoadResult result;
+        result.index = job.index;
+        try {
+            result.report = ExcelParser::parseReport(job.filePath);
+        } catch (const std::exception &e) {
+            result.error = QString::fromUtf8(e.what());
+        }
+        return result;
+    }));
+}
+
+void PortfolioLoader::onReportsLoaded()
+{
+    QList<LoadResult> results = m_watcher->future().results();
+    m_watcher->deleteLater();
+    m_watcher = nullptr;
+
+    std::sort(results.begin(), results.end(), [](const LoadResult &a, const LoadResult &b) {
+        return a.index < b.index;
+    });
+
+    QVector<TradeTable> tables;
+    QVector<double> initialBalances;
+    tables.reserve(results.size());
+    initialBalances.reserve(results.size());
+
+    for (auto &result : results) {
+        if (!result.error.isEmpty()) {
+            QString fileName = QFileInfo(ExcelParser::localFilePath(m_filePaths[result.index])).fileName();
+            emit loadingFailed(QString("Failed to parse %1: %2").arg(fileName, result.error));
+            return;
+        }
+        tables.append(std::move(result.report.trades));
+        initialBalances.append(result.report.initialBalance);
+    }
+
+    m_stream = mergeByCloseTime(tables, initialBalances, m_weights);
+    emit loadingComplete(m_stream.initialBalance, m_stream.size(), tables.size());
+}
+
+PortfolioStream PortfolioLoader::mergeByCloseTime(const QVector<TradeTable> &tables,
+                                                  const QVector<double> &initialBalances,
+                                                  const QVector<double> &weights)
+{
+    PortfolioStream stream;
+
+    const int strategies = tables.size();
+    int totalTrades = 0;
+    for (const auto &table : tables) {
+        totalTrades += table.size();
+    }
+
+    stream.closeTime.reserve(totalTrades);
+    stream.outcome.reserve(totalTrades);
+
+    auto weightOf = [&weights](int strategy) {
+        return strategy < weights.size() ? weights[strategy] : 1.0;
+    };
+
+    for (int s = 0; s < strategies; ++s) {
+        stream.initialBalance += weightOf(s) * initialBalances.value(s);
+    }
+
+    // reports list deals chronologically, so the close order only needs fixing
+    // when a position closed out of sequence
+    QVector<QVector<int>> order(strategies);
+    for (int s = 0; s < strategies; ++s) {
+        const auto &closeTime = tables[s].closeTime;
+        order[s].resize(tables[s].size());
+        std::iota(order[s].begin(), order[s].end(), 0);
+        if (!std::is_sorted(closeTime.begin(), closeTime.end())) {
+            std::stable_sort(order[s].begin(), order[s].end(), [&closeTime](int a, int b) {
+                return closeTime[a] < closeTime[b];
+            });
+        }
+    }
+
+    // (close time, strategy) heads; ties resolve to the earlier report
+    using Head = std::pair<qint64, int>;
+    std::priority_queue<Head, std::vector<Head>, std::greater<Head>> heads;
+    QVector<int> cursor(strategies, 0);
+
+    for (int s = 0; s < strategies; ++s) {
+        if (!order[s].isEmpty()) {
+            heads.push({tables[s].closeTime[order[s][0]], s});
+        }
+    }
+
+    while (!heads.empty()) {
+        const int s = heads.top().second;
+        heads.pop();
+
+        const int trade = order[s][cursor[s]++];
+        const qint64 closeTime = tables[s].closeTime[trade];
+
+        if (stream.closeTime.isEmpty() || dayOf(closeTime) != dayOf(stream.closeTime.last())) {
+            stream.dayStarts.append(stream.size());
+        }
+
+        stream.closeTime.append(closeTime);
+        stream.outcome.append(weightOf(s) * tables[s].outcome[trade]);
+
+        if (cursor[s] < order[s].size()) {
+            heads.push({tables[s].closeTime[order[s][cursor[s]]], s});
+        }
+    }
+
+    return stream;
+}
@@ -0,0 +1,64 @@
+#ifndef PORTFOLIOLOADER_H
+#define PORTFOLIOLOADER_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QFutureWatcher>
+#include "DealExtractor.h"
+#include "ExcelParser.h"
+
+
+// trades of several strategies interleaved by close time
+struct PortfolioStream {
+    QVector<qint64> closeTime;
+    QVector<double> outcome;      // weighted net outcome
+    QVector<int> dayStarts;       // first trade of every calendar day
+    double initialBalance = 0;    // weighted sum of the reports' deposits
+
+    int size() const { return outcome.size(); }
+};
+
+
+// loads a basket of MT5 reports in parallel, one parse per report on the global
+// thread pool, and merges them into a single portfolio outcome stream
+class PortfolioLoader : public QObject
+{
+    Q_OBJECT
+public:
+    explicit PortfolioLoader(QObject *parent = nullptr);
+
+    Q_INVOKABLE QVector<double> getTradeOutcomes() const { return m_stream.outcome; }
+    Q_INVOKABLE QVector<int> getDayStarts() const { return m_stream.dayStarts; }
+    Q_INVOKABLE double getInitialBalance() const { return m_stream.initialBalance; }
+
+    // k-way merge on close time; a missing weight counts as 1
+    static PortfolioStream mergeByCloseTime(const QVector<TradeTable> &tables,
+                                            const QVector<double> &initialBalances,
+                                            const QVector<double> &weights);
+
+public slots:
+    void loadReports(const QStringList &filePaths, const QVector<double> &weights);
+
+signals:
+    void loadingProgress(int current, int total);
+    void loadingComplete(double initialBalance, int tradeCount, int reportCount);
+    void loadingFailed(const QString &error);
+
+private:
+    struct LoadResult {
+        int index = 0;
+        ExcelParser::ParsedReport report;
+        QString error;
+    };
+
+    void onReportsLoaded();
+
+    QFutureWatcher<LoadResult> *m_watcher;
+    QStringList m_filePaths;
+    QVector<double> m_weights;
+    PortfolioStream m_stream;
+};
+
+#endif
@@ -0,0 +1,163 @@
+#include "ReportTokenizer.h"
+#include <algorithm>
+
+namespace {
+
+bool isSpace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+char toLowerAscii(char c)
+{
+    return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+std::string_view trimmed(std::string_view text)
+{
+    while (!text.empty() && isSpace(text.front())) text.remove_prefix(1);
+    while (!text.empty() && isSpace(text.back())) text.remove_suffix(1);
+    return text;
+}
+
+bool tagAt(std::string_view data, size_t i, std::string_view tag)
+{
+    if (i + 1 + tag.size() >= data.size()) return false;
+
+    for (size_t k = 0; k < tag.size(); ++k) {
+        if (toLowerAscii(data[i + 1 + k]) != tag[k]) return false;
+    }
+
+    char next = data[i + 1 + tag.size()];
+    return next == '>' || isSpace(next);
+}
+
+// position of the first "<tag" or "<altTag" (case-insensitive) in [from, to), or npos
+size_t findTag(std::string_view data, std::string_view tag, size_t from, size_t to,
+               std::string_view altTag = {})
+{
+    to = std::min(to, data.size());
+    for (size_t i = data.find('<', from); i != std::string_view::npos && i < to; i = data.find('<', i + 1)) {
+        if (tagAt(data, i, tag) || (!altTag.empty() && tagAt(data, i, altTag))) return i;
+    }
+    return std::string_view::npos;
+}
+
+}
+
+ReportTokenizer::ReportTokenizer(std::string_view data, Format format)
+    : m_data(data)
+    , m_format(format)
+    , m_delimiter(format == Format::Csv ? detectDelimiter(data) : ',')
+    , m_pos(0)
+{
+}
+
+bool ReportTokenizer::nextRow(QVector<std::string_view> &cells)
+{
+    cells.clear();
+    return m_format == Format::Csv ? nextCsvRow(cells) : nextHtmlRow(cells);
+}
+
+bool ReportTokenizer::nextCsvRow(QVector<std::string_view> &cells)
+{
+    if (m_pos >= m_data.size()) {
+        return false;
+    }
+
+    size_t lineEnd = m_data.find('\n', m_pos);
+    if (lineEnd == std::string_view::npos) lineEnd = m_data.size();
+
+    std::string_view line = m_data.substr(m_pos, lineEnd - m_pos);
+    m_pos = lineEnd + 1;
+
+    size_t i = 0;
+    while (true) {
+        while (i < line.size() && line[i] == ' ') ++i;
+
+        size_t cellEnd;
+        if (i < line.size() && line[i] == '"') {
+            // quoted cell, doubled quotes stay escaped in the view
+            size_t close = i + 1;
+            while ((close = line.find('"', close)) != std::string_view::npos
+                   && close + 1 < line.size() && line[close + 1] == '"') {
+                close += 2;
+            }
+            if (close == std::string_view::npos) close = line.size();
+            cells.append(line.substr(i + 1, close - i - 1));
+            cellEnd = line.find(m_delimiter, close);
+        } else {
+            cellEnd = line.find(m_delimiter, i);
+            std::string_view cell = line.substr(i, (cellEnd == std::string_view::npos ? line.size() : cellEnd) - i);
+            cells.append(trimmed(cell));
+        }
+
+        if (cellEnd == std::string_view::npos) break;
+        i = cellEnd + 1;
+    }
+
+    return true;
+}
+
+bool ReportTokenizer::nextHtmlRow(QVector<std::string_view> &cells)
+{
+    size_t rowBegin = findTag(m_data, "tr", m_pos, m_data.size());
+    if (rowBegin == std::string_view::npos) {
+        m_pos = m_data.size();
+        return false;
+    }
+
+    size_t rowEnd = findTag(m_data, "/tr", rowBegin, m_data.size());
+    size_t nextRow = findTag(m_data, "tr", rowBegin + 1, m_data.size());
+    if (rowEnd == std::string_view::npos || (nextRow != std::string_view::npos && nextRow < rowEnd)) {
+        // tolerate an unclosed row
+        rowEnd = (nextRow == std::string_view::npos) ? m_data.size() : nextRow;
+    }
+
+    size_t p = rowBegin + 3;
+    while (p < rowEnd) {
+        size_t cellOpen = findTag(m_data, "td", p, rowEnd, "th");
+        if (cellOpen == std::string_view::npos) break;
+
+        size_t contentBegin = m_data.find('>', cellOpen);
+        if (contentBegin == std::string_view::npos || contentBegin >= rowEnd) break;
+        ++contentBegin;
+
+        size_t contentEnd = std::min(findTag(m_data, "/td", contentBegin, rowEnd, "/th"), rowEnd);
+
+        cells.append(htmlCellText(contentBegin, contentEnd));
+        p = contentEnd;
+    }
+
+    m_pos = rowEnd + 1;
+    return true;
+}
+
+std::string_view ReportTokenizer::htmlCellText(size_t contentBegin, size_t contentEnd) const
+{
+    std::string_view content = m_data.substr(contentBegin, contentEnd - contentBegin);
+
+    // skip wrapper tags such as <div><b>Deals</b></div> down to the first text
+    while (true) {
+        content = trimmed(content);
+        if (content.empty() || content.front() != '<') break;
+        size_t close = content.find('>');
+        if (close == std::string_view::npos) return {};
+        content.remove_prefix(close + 1);
+    }
+
+    size_t textEnd = content.find('<');
+    return trimmed(content.substr(0, textEnd));
+}
+
+char ReportTokenizer::detectDelimiter(std::string_view data)
+{
+    std::string_view sample = data.substr(0, 4096);
+    size_t tabs = std::count(sample.begin(), sample.end(), '\t');
+    size_t semicolons = std::count(sample.begin(), sample.end(), ';');
+    size_t commas = std::count(sample.begin(), sample.end(), ',');
+
+    if (tabs >= semicolons && tabs >= commas && tabs > 0) return '\t';
+    if (semicolons >= commas && semicolons > 0) return ';';
+    return ',';
+}
@@ -0,0 +1,38 @@
+#ifndef REPORTTOKENIZER_H
+#define REPORTTOKENIZER_H
+
+#include <QVector>
+#include <string_view>
+
+
+// splits an in-memory MT5 CSV or HTML report into rows of cells without copying;
+// every cell is a view into the buffer, so the buffer must outlive the rows
+class ReportTokenizer
+{
+public:
+    enum class Format {
+        Csv,
+        Html
+    };
+
+    ReportTokenizer(std::string_view data, Format format);
+
+    // fills cells with the next row, false once the input is exhausted
+    bool nextRow(QVector<std::string_view> &cells);
+
+    size_t position() const { return m_pos; }
+    size_t size() const { return m_data.size(); }
+
+private:
+    bool nextCsvRow(QVector<std::string_view> &cells);
+    bool nextHtmlRow(QVector<std::string_view> &cells);
+    std::string_view htmlCellText(size_t contentBegin, size_t contentEnd) const;
+    static char detectDelimiter(std::string_view data);
+
+    std::string_view m_data;
+    Format m_format;
+    char m_delimiter;
+    size_t m_pos;
+};
+
+#endif
@@ -0,0 +1,387 @@
+#include "ShardLauncher.h"
+#include "MonteCarloSimulator.h"
+#include <QCoreApplication>
+#include <QDataStream>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QTextStream>
+#include <QThread>
+#include <QVariantMap>
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+
+namespace {
+
+const char kWorkerFlag[] = "--mc-worker";
+
+struct ShardInput {
+    QVector<double> outcomes;
+    QVector<int> blockStarts;
+    double initialBalance = 0;
+    quint64 seed = 0;
+    bool randomizeOrder = true;
+    int samplingMode = MonteCarloSimulator::IndependentSampling;
+    MonteCarloSimulator::StressScenario stress;
+};
+
+bool writeInput(const QString &path, const ShardInput &input)
+{
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+    QDataStream out(&file);
+    out << input.outcomes << input.blockStarts << input.initialBalance << input.seed << input.randomizeOrder
+        << input.samplingMode << input.stress;
+    return out.status() == QDataStream::Ok && file.commit();
+}
+
+bool readInput(const QString &path, ShardInput &input)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    QDataStream in(&file);
+    in >> input.outcomes >> input.blockStarts >> input.initialBalance >> input.seed >> input.randomizeOrder
+       >> input.samplingMode >> input.stress;
+    return in.status() == QDataStream::Ok
+        && input.samplingMode >= MonteCarloSimulator::IndependentSampling
+        && input.samplingMode <= MonteCarloSimulator::StratifiedSampling;
+}
+
+}
+
+ShardLauncher::ShardLauncher(QObject *parent)
+    : QObject(parent)
+    , m_finishedCount(0)
+    , m_numSimulations(0)
+    , m_confidenceLevel(0)
+    , m_samplingMode(MonteCarloSimulator::IndependentSampling)
+    , m_stressed(false)
+{
+    std::random_device rd;
+    m_generator = std::mt19937(rd());
+}
+
+ShardLauncher::~ShardLauncher()
+{
+    cleanup();
+}
+
+bool ShardLauncher::isWorkerInvocation(int argc, char *argv[])
+{
+    return argc > 1 && std::strcmp(argv[1], kWorkerFlag) == 0;
+}
+
+int ShardLauncher::runWorker(const QStringList &arguments)
+{
+    // <app> --mc-worker <input> <output> <firstRun> <runCount>
+    int flag = arguments.indexOf(QString::fromLatin1(kWorkerFlag));
+    if (flag < 0 || arguments.size() < flag + 5) {
+        qWarning() << "Usage:" << kWorkerFlag << "<input> <output> <firstRun> <runCount>";
+        return 2;
+    }
+
+    ShardInput input;
+    if (!readInput(arguments[flag + 1], input)) {
+        qWarning() << "Failed to read shard input" << arguments[flag + 1];
+        return 1;
+    }
+
+    int firstRun = arguments[flag + 3].toInt();
+    int runCount = arguments[flag + 4].toInt();
+
+    MonteCarloSimulator simulator;
+
+    // progress goes to the launcher one line per update
+    QTextStream progressOut(stdout);
+    QObject::connect(&simulator, &MonteCarloSimulator::simulationProgress,
+                     [&progressOut](int current, int) {
+                         progressOut << current << Qt::endl;
+                     });
+
+    MonteCarloSimulator::PartialAggregate partial;
+    MonteCarloSimulator::PartialAggregate stressedPartial;
+    try {
+        partial = simulator.runShard(input.outcomes, input.blockStarts, input.initialBalance, input.seed,
+                                     firstRun, runCount, input.randomizeOrder,
+                                     static_cast<MonteCarloSimulator::SamplingMode>(input.samplingMode),
+                                     input.stress, &stressedPartial);
+    } catch (const std::exception &e) {
+        qWarning() << "Shard failed:" << e.what();
+        return 1;
+    }
+
+    QSaveFile output(arguments[flag + 2]);
+    if (!output.open(QIODevice::WriteOnly)) {
+        qWarning() << "Failed to open shard output" << arguments[flag + 2];
+        return 1;
+    }
+    QDataStream out(&output);
+    out << partial;
+    if (stressedPartial.stressed) {
+        out << stressedPartial;
+    }
+    return (out.status() == QDataStream::Ok && output.commit()) ? 0 : 1;
+}
+
+void ShardLauncher::runShardedSimulation(const QVector<double> &outcomes,
+                                         double initialBalance,
+                                         int numSimulations,
+                                         bool randomizeOrder,
+                                         double confidenceLevel,
+                                         int workerCount,
+                                         const QVector<int> &blockStarts)
+{
+    if (!m_workers.isEmpty()) {
+        emit simulationFailed("A sharded simulation is already running");
+        return;
+    }
+
+    if (outcomes.isEmpty()) {
+        emit simulationFailed("No trade data available");
+        return;
+    }
+
+    if (initialBalance <= 0) {
+        emit simulationFailed("Initial balance must be positive");
+        return;
+    }
+
+    if (numSimulations <= 0) {
+        emit simulationFailed("Number of simulations must be positive");
+        return;
+    }
+
+    if (workerCount <= 0) {
+        workerCount = QThread::idealThreadCount();
+    }
+    workerCount = std::max(1, std::min(workerCount, numSimulations));
+
+    m_workDir = std::make_unique<QTemporaryDir>();
+    if (!m_workDir->isValid()) {
+        m_workDir.reset();
+        emit simulationFailed("Failed to create a working directory for worker processes");
+        return;
+    }
+
+    ShardInput input;
+    input.outcomes = outcomes;
+    input.blockStarts = blockStarts;
+    input.initialBalance = initialBalance;
+    input.seed = (static_cast<quint64>(m_generator()) << 32) | m_generator();
+    input.randomizeOrder = randomizeOrder;
+    input.samplingMode = m_samplingMode;
+    input.stress = m_stressScenario;
+    m_stressed = input.stress.isActive();
+
+    const QString inputPath = m_workDir->filePath("input.bin");
+    if (!writeInput(inputPath, input)) {
+        m_workDir.reset();
+        emit simulationFailed("Failed to write worker input");
+        return;
+    }
+
+    m_finishedCount = 0;
+    m_numSimulations = numSimulations;
+    m_confidenceLevel = confidenceLevel;
+
+    // on multi-socket Linux hosts pin each worker's threads and memory to one node
+    const int nodes = numaNodeCount();
+    const QString numactl = nodes > 1 ? QStandardPaths::findExecutable("numactl") : QString();
+
+    QVector<QString> programs;
+    QVector<QStringList> arguments;
+
+    int firstRun = 0;
+    for (int shard = 0; shard < workerCount; ++shard) {
+        int runCount = numSimulations / workerCount + (shard < numSimulations % workerCount ? 1 : 0);
+
+        QString program = QCoreApplication::applicationFilePath();
+        QStringList args = {
+            kWorkerFlag,
+            inputPath,
+            shardOutputPath(shard),
+            QString::number(firstRun),
+            QString::number(runCount)
+        };
+
+        if (!numactl.isEmpty()) {
+            int node = shard % nodes;
+            args.prepend(program);
+            args.prepend(QString("--membind=%1").arg(node));
+            args.prepend(QString("--cpunodebind=%1").arg(node));
+            program = numactl;
+        }
+
+        auto *process = new QProcess(this);
+        connect(process, &QProcess::readyReadStandardOutput, this, [this, shard]() {
+            onWorkerOutput(shard);
+        });
+        connect(process, &QProcess::finished, this, [this, shard](int exitCode, QProcess::ExitStatus exitStatus) {
+            onWorkerFinished(shard, exitCode, exitStatus);
+        });
+        connect(process, &QProcess::errorOccurred, this, [this, shard](QProcess::ProcessError error) {
+            if (error == QProcess::FailedToStart) {
+                fail(QString("Worker %1 failed to start").arg(shard));
+            }
+        });
+
+        m_workers.append(process);
+        m_shardProgress.append(0);
+        programs.append(program);
+        arguments.append(args);
+        firstRun += runCount;
+    }
+
+    // a failed start tears every worker down, so stop launching once that happens
+    for (int shard = 0; shard < programs.size() && !m_workers.isEmpty(); ++shard) {
+        m_workers[shard]->start(programs[shard], arguments[shard]);
+    }
+}
+
+void ShardLauncher::stopSimulation()
+{
+    if (m_workers.isEmpty()) {
+        return;
+    }
+
+    cleanup();
+    emit simulationStopped();
+}
+
+void ShardLauncher::setSamplingMode(int mode)
+{
+    m_samplingMode = mode == MonteCarloSimulator::StratifiedSampling
+        ? MonteCarloSimulator::StratifiedSampling
+        : MonteCarloSimulator::IndependentSampling;
+}
+
+void ShardLauncher::setStressScenario(double winnerHaircut, double loserInflation, double skipFraction,
+                                      double costPerTrade, int lossStreaks, int lossStreakLength)
+{
+    m_stressScenario = MonteCarloSimulator::StressScenario::bounded(winnerHaircut, loserInflation, skipFraction,
+                                                                    costPerTrade, lossStreaks, lossStreakLength);
+}
+
+void ShardLauncher::onWorkerOutput(int shard)
+{
+    QProcess *process = m_workers.value(shard);
+    if (!process) {
+        return;
+    }
+
+    while (process->canReadLine()) {
+        bool ok = false;
+        int current = process->readLine().trimmed().toInt(&ok);
+        if (ok) {
+            m_shardProgress[shard] = current;
+        }
+    }
+
+    int total = std::accumulate(m_shardProgress.begin(), m_shardProgress.end(), 0);
+    emit simulationProgress(total, m_numSimulations);
+}
+
+void ShardLauncher::onWorkerFinished(int shard, int exitCode, QProcess::ExitStatus exitStatus)
+{
+    if (exitStatus != QProcess::NormalExit || exitCode != 0) {
+        fail(QString("Worker %1 exited with code %2").arg(shard).arg(exitCode));
+        return;
+    }
+
+    m_finishedCount++;
+    if (m_finishedCount == m_workers.size()) {
+        collectResults();
+    }
+}
+
+void ShardLauncher::collectResults()
+{
+    QVector<MonteCarloSimulator::PartialAggregate> partials;
+    QVector<MonteCarloSimulator::PartialAggregate> stressedPartials;
+    partials.reserve(m_workers.size());
+    const bool stressed = m_stressed;
+
+    for (int shard = 0; shard < m_workers.size(); ++shard) {
+        QFile file(shardOutputPath(shard));
+        if (!file.open(QIODevice::ReadOnly)) {
+            fail(QString("Missing result of worker %1").arg(shard));
+            return;
+        }
+
+        MonteCarloSimulator::PartialAggregate partial;
+        MonteCarloSimulator::PartialAggregate stressedPartial;
+        QDataStream in(&file);
+        in >> partial;
+        if (stressed) {
+            in >> stressedPartial;
+        }
+        if (in.status() != QDataStream::Ok) {
+            fail(QString("Corrupt result of worker %1").arg(shard));
+            return;
+        }
+        partials.append(partial);
+        if (stressed) {
+            stressedPartials.append(stressedPartial);
+        }
+    }
+
+    try {
+        auto merged = MonteCarloSimulator::mergePartials(partials);
+        auto metrics = MonteCarloSimulator::finalizeAggregate(merged, m_confidenceLevel);
+        QVariantMap metricsMap = MonteCarloSimulator::metricsToVariantMap(metrics);
+        if (stressed) {
+            auto stressedMerged = MonteCarloSimulator::mergePartials(stressedPartials);
+            metricsMap["stressed"] = MonteCarloSimulator::metricsToVariantMap(
+                MonteCarloSimulator::finalizeAggregate(stressedMerged, m_confidenceLevel));
+        }
+        cleanup();
+        emit simulationComplete(metricsMap);
+    } catch (const std::exception &e) {
+        fail(QString("Simulation error: %1").arg(e.what()));
+    }
+}
+
+void ShardLauncher::fail(const QString &error)
+{
+    cleanup();
+    emit simulationFailed(error);
+}
+
+void ShardLauncher::cleanup()
+{
+    for (QProcess *process : m_workers) {
+        process->disconnect(this);
+        if (process->state() != QProcess::NotRunning) {
+            process->kill();
+            process->waitForFinished(1000);
+        }
+        process->deleteLater();
+    }
+    m_workers.clear();
+    m_shardProgress.clear();
+    m_finishedCount = 0;
+    m_workDir.reset();
+}
+
+QString ShardLauncher::shardOutputPath(int shard) const
+{
+    return m_workDir->filePath(QString("shard%1.bin").arg(shard));
+}
+
+int ShardLauncher::numaNodeCount()
+{
+#ifdef Q_OS_LINUX
+    QDir nodes("/sys/devices/system/node");
+    int count = nodes.entryList({"node[0-9]*"}, QDir::Dirs | QDir::NoDotAndDotDot).size();
+    return std::max(count, 1);
+#else
+    return 1;
+#endif
+}
@@ -0,0 +1,64 @@
+#ifndef SHARDLAUNCHER_H
+#define SHARDLAUNCHER_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QProcess>
+#include <QTemporaryDir>
+#include <memory>
+#include <random>
+#include "MonteCarloSimulator.h"
+
+
+// splits one simulation job across local worker processes (the app re-launched
+// with --mc-worker), each covering a disjoint run range, and merges their partials
+class ShardLauncher : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ShardLauncher(QObject *parent = nullptr);
+    ~ShardLauncher();
+
+    static bool isWorkerInvocation(int argc, char *argv[]);
+    static int runWorker(const QStringList &arguments);
+
+public slots:
+    void runShardedSimulation(const QVector<double> &outcomes, double initialBalance, int numSimulations,
+                              bool randomizeOrder, double confidenceLevel, int workerCount,
+                              const QVector<int> &blockStarts = QVector<int>());
+    void stopSimulation();
+    void setSamplingMode(int mode);
+    void setStressScenario(double winnerHaircut, double loserInflation, double skipFraction,
+                           double costPerTrade, int lossStreaks, int lossStreakLength);
+
+signals:
+    void simulationProgress(int current, int total);
+    void simulationComplete(const QVariantMap &metrics);
+    void simulationFailed(const QString &error);
+    void simulationStopped();
+
+private:
+    void onWorkerOutput(int shard);
+    void onWorkerFinished(int shard, int exitCode, QProcess::ExitStatus exitStatus);
+    void collectResults();
+    void fail(const QString &error);
+    void cleanup();
+    QString shardOutputPath(int shard) const;
+    static int numaNodeCount();
+
+    QVector<QProcess *> m_workers;
+    QVector<int> m_shardProgress;
+    std::unique_ptr<QTemporaryDir> m_workDir;
+    int m_finishedCount;
+    int m_numSimulations;
+    double m_confidenceLevel;
+    int m_samplingMode;
+    MonteCarloSimulator::StressScenario m_stressScenario;
+    bool m_stressed;    // the running job carries stressed partials
+    std::mt19937 m_generator;
+};
+
+#endif
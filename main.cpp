@@ -1,36 +1,60 @@
 #include <QGuiApplication>
 #include <QQmlApplicationEngine>
 #include <QQmlContext>
+#include <QQuickWindow>
+#include <QElapsedTimer>
+#include <QTextStream>
+#include <QTimer>
 #include "ExcelParser.h"
 #include "StatusBarManager.h"
 #include "MonteCarloSimulator.h"
-
-
+#include "ShardLauncher.h"
+#include "PortfolioLoader.h"
 
 
 int main(int argc, char *argv[])
 {
+    QElapsedTimer startupTimer;
+    startupTimer.start();
+
+    // sharded runs re-launch this executable as a headless worker
+    if (ShardLauncher::isWorkerInvocation(argc, argv)) {
+        QCoreApplication app(argc, argv);
+        return ShardLauncher::runWorker(app.arguments());
+    }
+
     QGuiApplication app(argc, argv);
 
+    // prints the startup timings and quits after the first frame
+    const bool startupBenchmark = app.arguments().contains("--startup-benchmark");
+
+    // engines are cheap to construct and must be published before the QML loads,
+    // a context property set later re-evaluates every binding in Main.qml
     ExcelParser excelParser;
     StatusBarManager statusBarManager;
     MonteCarloSimulator monteCarloSimulator;
+    ShardLauncher shardLauncher;
+    PortfolioLoader portfolioLoader;
 
     // parser signals
     QObject::connect(&excelParser, &ExcelParser::parsingProgress,
     &statusBarManager, &StatusBarManager::updateParsingProgress);
+    QObject::connect(&portfolioLoader, &PortfolioLoader::loadingProgress,
+                     &statusBarManager, &StatusBarManager::updateParsingProgress);
 
     // sim progress
     QObject::connect(&monteCarloSimulator, &MonteCarloSimulator::simulationProgress,
                      &statusBarManager, &StatusBarManager::updateSimulationProgress);
-
-
+    QObject::connect(&shardLauncher, &ShardLauncher::simulationProgress,
+                     &statusBarManager, &StatusBarManager::updateSimulationProgress);
 
     QQmlApplicationEngine engine;
 
     engine.rootContext()->setContextProperty("excelParser", &excelParser);
     engine.rootContext()->setContextProperty("statusBarManager", &statusBarManager);
     engine.rootContext()->setContextProperty("monteCarloSimulator", &monteCarloSimulator);
+    engine.rootContext()->setContextProperty("shardLauncher", &shardLauncher);
+    engine.rootContext()->setContextProperty("portfolioLoader", &portfolioLoader);
 
 
     const QUrl url(QStringLiteral("qrc:/MT5MonteCarlo/Main.qml"));
@@ -45,5 +69,29 @@ int main(int argc, char *argv[])
         Qt::QueuedConnection);
     engine.load(url);
 
+    const qint64 qmlLoadedMs = startupTimer.elapsed();
+
+    auto *window = engine.rootObjects().isEmpty()
+        ? nullptr
+        : qobject_cast<QQuickWindow *>(engine.rootObjects().first());
+
+    if (window) {
+        QObject::connect(
+            window,
+            &QQuickWindow::frameSwapped,
+            &app,
+            [&]() {
+                const qint64 firstFrameMs = startupTimer.elapsed();
+
+                if (startupBenchmark) {
+                    QTextStream out(stdout);
+                    out << "qml loaded: " << qmlLoadedMs << " ms\n"
+                        << "time to first frame: " << firstFrameMs << " ms" << Qt::endl;
+                    QTimer::singleShot(0, &app, &QCoreApplication::quit);
+                }
+            },
+            Qt::SingleShotConnection);
+    }
+
     return app.exec();
 }